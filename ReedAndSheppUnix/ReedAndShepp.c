@@ -1,1338 +1,1573 @@
-// ReedAndSheppDll.cpp : définit les fonctions exportées pour l'application DLL.
-//
-
-#include <stdio.h>
-#include <math.h>
-
-#define EXPORT __attribute__((visibility("default")))
-
-// Initializer.
-__attribute__((constructor))
-static void initializer(void) {                             // 2
-}
- 
-// Finalizer.
-__attribute__((destructor))
-static void finalizer(void) {                               // 3
-}
-
-/*
-
-The functions c_c_c through cs2_cb compute the lengths of the RS curves, for
-a certain increment of configuration (x,y,phi) computed in the function
-reed-shepp.
-
-The function reed-shepp computes the increment between two configurations and
-scans all RS curves to determine the shortest one. It is called through the
-function min_length_rs to avoid a too small increment (which could yield
-numerical errors).
-
-The function constRS computes the discretized path (in pathx, pathy,
-and patht) of the RS curve number NUM, parameters t, u and v, starting
-at (x1,y1,t1).  It calls fct_curve that computes the path for a right
-circular arc, left circular atc, and straight line. The discretization
-done in fct-curve is rather ugly, and you could rewrite this function.
-
-
-
-What is the significance of the parameters to reed_shepp() ?
-
-From the brief description of the RS curves given in HO 9 you can
-gather that RS curves consist of 3 to 5 segments (straight segments
-and/or circular arcs). However, at most 3 have unpredetermined
-lengths.  The parameters tr, ur, vr are intended to contain these
-lengths.  For example, the first call in the function reed_shepp() is
-to c_c_c(). The pointers to tn, un, and vn are passed to c_c_c(),
-which computes the length of the 3 circular arcs of this RS curve. At
-the end, reed_shepp puts in tr, ur, and vr the parameters
-corresponding to the shortest RS curves found.  The unit of length for
-a straight segment is whatever you want.  For a circular arc it is in
-radians.
-
-The parameter numero is just the number identifying a RS curve.  The
-value given at the end of reed-shepp is the number (1 to 48)
-identifying the shortes RS curve found between the two given
-configurations.
-
-
-*/
-
-#define EPS1 1.0e-12
-#define EPS2 1.0e-12
-#define EPS3 1.0e-12
-#define EPS4 1.0e-12
-#define INFINITY 10000
-
-#define MPI 3.1415926536
-#define MPIMUL2 6.2831853072
-#define MPIDIV2 1.5707963268
-
-
-/*
-
-RADCURV is the radius of the circular arcs in the RS curves (the
-turning radius of the robot). It is in whatever units you want.
-
-RADCURVMUL2 is defined as 2 * RADCURV
-RADCURVMUL4 is defined as 4 * RADCURV
-SQRADCURV   is defined as RADCURV * RADCURV
-SQRADCURVMUL2 is defined as 4 * RADCURV * RADCURV
-
-*/
-
-double RADCURV = 1.0;
-double RADCURVMUL2 = 2.0;
-double RADCURVMUL4 = 4.0;
-double SQRADCURV = 1.0;
-double SQRADCURVMUL2 = 4.0;
-
-EXPORT
-void change_radcurv(double radcurv)
-{
-	RADCURV = radcurv;
-	RADCURVMUL2 = 2 * RADCURV;
-	RADCURVMUL4 = 4 * RADCURV;
-	SQRADCURV = RADCURV * RADCURV;
-	SQRADCURVMUL2 = 4 * RADCURV * RADCURV;
-}
-
-/***********************************************************/
-double mod2pi(double angle)
-{
-	while (angle < 0.0) angle = angle + MPIMUL2;
-	while (angle >= MPIMUL2) angle = angle - MPIMUL2;
-	return angle;
-}
-
-
-/***********************************************************/
-double my_atan2(double y, double x)
-{
-	double a;
-	if ((x == 0.0) && (y == 0.0)) return 0.0;
-	if (x == 0.0)
-		if (y > 0) return MPIDIV2;
-		else return -MPIDIV2;
-	a = atan(y / x);
-	if (a > 0.0)
-		if (x > 0) return a;
-		else return (a + MPI);
-	else
-		if (x > 0) return (a + MPIMUL2);
-		else return (a + MPI);
-}
-
-
-/***********************************************************/
-double c_c_c(double x, double y, double phi, double rs, double rc, double* t, double *u, double* v)
-{
-	double a, b, u1, theta, alpha, length_rs;
-
-	a = x - rs;
-	b = y + rc;
-	if ((fabs(a)<EPS3) && (fabs(b)<EPS3)) return(INFINITY);
-	u1 = sqrt(a*a + b * b);
-	if (u1>RADCURVMUL4) return(INFINITY);
-	theta = my_atan2(b, a);
-	alpha = acos(u1 / RADCURVMUL4);
-	*t = mod2pi(MPIDIV2 + alpha + theta);
-	*u = mod2pi(MPI - 2 * alpha);
-	*v = mod2pi(phi - *t - *u);
-
-	length_rs = RADCURV * (*t + *u + *v);
-	return(length_rs);
-}
-
-
-/***********************************************************/
-double c_cc(double x, double y, double phi, double rs, double rc, double* t, double *u, double* v)
-{
-	double a, b, u1, theta, alpha, length_rs;
-
-	a = x - rs;
-	b = y + rc;
-	if ((fabs(a)<EPS3) && (fabs(b)<EPS3)) return(INFINITY);
-	u1 = sqrt(a*a + b * b);
-	if (u1>RADCURVMUL4) return(INFINITY);
-	theta = my_atan2(b, a);
-	alpha = acos(u1 / RADCURVMUL4);
-	*t = mod2pi(MPIDIV2 + alpha + theta);
-	*u = mod2pi(MPI - 2 * alpha);
-	*v = mod2pi(*t + *u - phi);
-
-	length_rs = RADCURV * (*t + *u + *v);
-	return(length_rs);
-}
-
-
-/***********************************************************/
-double csca(double x, double y, double phi, double rs, double rc, double* t, double *u, double* v)
-{
-	double a, b, length_rs;
-
-	a = x - rs;
-	b = y + rc;
-	*t = mod2pi(my_atan2(b, a));
-	*u = sqrt(a*a + b * b);
-	*v = mod2pi(phi - *t);
-
-	length_rs = RADCURV * (*t + *v) + *u;
-	return(length_rs);
-}
-
-
-/***********************************************************/
-double cscb(double x, double y, double phi, double rs, double rc, double* t, double *u, double* v)
-{
-	double a, b, u1, theta, alpha, length_rs;
-
-	a = x + rs;
-	b = y - rc;
-	u1 = sqrt(a*a + b * b);
-	if (u1 < RADCURVMUL2) return(INFINITY);
-	theta = my_atan2(b, a);
-	*u = sqrt(u1*u1 - SQRADCURVMUL2);
-	alpha = my_atan2(RADCURVMUL2, *u);
-	*t = mod2pi(theta + alpha);
-	*v = mod2pi(*t - phi);
-
-	length_rs = RADCURV * (*t + *v) + *u;
-	return(length_rs);
-}
-
-
-/***********************************************************/
-double ccu_cuc(double x, double y, double phi, double rs, double rc, double* t, double *u, double* v)
-{
-	double a, b, u1, theta, alpha, length_rs;
-
-	a = x + rs;
-	b = y - rc;
-	if ((fabs(a)<EPS3) && (fabs(b)<EPS3)) return(INFINITY);
-	u1 = sqrt(a*a + b * b);
-	if (u1 > RADCURVMUL4) return(INFINITY);
-	theta = my_atan2(b, a);
-	if (u1>RADCURVMUL2)
-	{
-		alpha = acos((u1 / 2 - RADCURV) / RADCURVMUL2);
-		*t = mod2pi(MPIDIV2 + theta - alpha);
-		*u = mod2pi(MPI - alpha);
-		*v = mod2pi(phi - *t + 2 * (*u));
-	}
-	else
-	{
-		alpha = acos((u1 / 2 + RADCURV) / (RADCURVMUL2));
-		*t = mod2pi(MPIDIV2 + theta + alpha);
-		*u = mod2pi(alpha);
-		*v = mod2pi(phi - *t + 2 * (*u));
-	}
-
-	length_rs = RADCURV * (2 * (*u) + *t + *v);
-	return(length_rs);
-}
-
-
-/***********************************************************/
-double c_cucu_c(double x, double y, double phi, double rs, double rc, double* t, double *u, double* v)
-{
-	double a, b, u1, theta, alpha, length_rs, va1, va2;
-
-	a = x + rs;
-	b = y - rc;
-	if ((fabs(a)<EPS3) && (fabs(b)<EPS3)) return(INFINITY);
-	u1 = sqrt(a*a + b * b);
-	if (u1 > 6 * RADCURV) return(INFINITY);
-	theta = my_atan2(b, a);
-	va1 = (5 * SQRADCURV - u1 * u1 / 4) / SQRADCURVMUL2;
-	if ((va1 < 0.0) || (va1 > 1.0)) return(INFINITY);
-	*u = acos(va1);
-	va2 = sin(*u);
-	alpha = asin(RADCURVMUL2*va2 / u1);
-	*t = mod2pi(MPIDIV2 + theta + alpha);
-	*v = mod2pi(*t - phi);
-
-	length_rs = RADCURV * (2 * (*u) + *t + *v);
-	return(length_rs);
-}
-
-
-/***********************************************************/
-double c_c2sca(double x, double y, double phi, double rs, double rc, double* t, double *u, double* v)
-{
-	double a, b, u1, theta, alpha, length_rs;
-
-	a = x - rs;
-	b = y + rc;
-	u1 = sqrt(a*a + b * b);
-	if (u1 < RADCURVMUL2) return(INFINITY);
-	theta = my_atan2(b, a);
-	*u = sqrt(u1*u1 - SQRADCURVMUL2) - RADCURVMUL2;
-	if (*u < 0.0) return(INFINITY);
-	alpha = my_atan2(RADCURVMUL2, (*u + RADCURVMUL2));
-	*t = mod2pi(MPIDIV2 + theta + alpha);
-	*v = mod2pi(*t + MPIDIV2 - phi);
-
-	length_rs = RADCURV * (*t + MPIDIV2 + *v) + *u;
-	return(length_rs);
-}
-
-
-/***********************************************************/
-double c_c2scb(double x, double y, double phi, double rs, double rc, double* t, double *u, double* v)
-{
-	double a, b, u1, theta, length_rs;
-
-	a = x + rs;
-	b = y - rc;
-	u1 = sqrt(a*a + b * b);
-	if (u1 < RADCURVMUL2) return(INFINITY);
-	theta = my_atan2(b, a);
-	*t = mod2pi(MPIDIV2 + theta);
-	*u = u1 - RADCURVMUL2;
-	*v = mod2pi(phi - *t - MPIDIV2);
-
-	length_rs = RADCURV * (*t + MPIDIV2 + *v) + *u;
-	return(length_rs);
-}
-
-
-/***********************************************************/
-double c_c2sc2_c(double x, double y, double phi, double rs, double rc, double* t, double *u, double* v)
-{
-	double a, b, u1, theta, alpha, length_rs;
-
-	a = x + rs;
-	b = y - rc;
-	u1 = sqrt(a*a + b * b);
-	if (u1 < RADCURVMUL4) return(INFINITY);
-	theta = my_atan2(b, a);
-	*u = sqrt(u1*u1 - SQRADCURVMUL2) - RADCURVMUL4;
-	if (*u < 0.0) return(INFINITY);
-	alpha = my_atan2(RADCURVMUL2, (*u + RADCURVMUL4));
-	*t = mod2pi(MPIDIV2 + theta + alpha);
-	*v = mod2pi(*t - phi);
-
-	length_rs = RADCURV * (*t + MPI + *v) + *u;
-	return(length_rs);
-}
-
-
-/***********************************************************/
-double cc_c(double x, double y, double phi, double rs, double rc, double* t, double *u, double* v)
-{
-	double a, b, u1, theta, alpha, length_rs, va;
-
-	a = x - rs;
-	b = y + rc;
-	if ((fabs(a)<EPS3) && (fabs(b)<EPS3)) return(INFINITY);
-	u1 = sqrt(a*a + b * b);
-	if (u1>RADCURVMUL4) return(INFINITY);
-	theta = my_atan2(b, a);
-	*u = acos((8 * SQRADCURV - u1 * u1) / (8 * SQRADCURV));
-	va = sin(*u);
-	if (fabs(va)<0.001) va = 0.0;
-	if ((fabs(va)<0.001) && (fabs(u1)<0.001)) return(INFINITY);
-	alpha = asin(RADCURVMUL2*va / u1);
-	*t = mod2pi(MPIDIV2 - alpha + theta);
-	*v = mod2pi(*t - *u - phi);
-
-	length_rs = RADCURV * (*t + *u + *v);
-	return(length_rs);
-}
-
-
-/***********************************************************/
-double csc2_ca(double x, double y, double phi, double rs, double rc, double* t, double *u, double* v)
-{
-	double a, b, u1, theta, alpha, length_rs;
-
-	a = x - rs;
-	b = y + rc;
-	u1 = sqrt(a*a + b * b);
-	if (u1 < RADCURVMUL2) return(INFINITY);
-	theta = my_atan2(b, a);
-	*u = sqrt(u1*u1 - SQRADCURVMUL2) - RADCURVMUL2;
-	if (*u < 0.0) return(INFINITY);
-	alpha = my_atan2((*u + RADCURVMUL2), RADCURVMUL2);
-	*t = mod2pi(MPIDIV2 + theta - alpha);
-	*v = mod2pi(*t - MPIDIV2 - phi);
-
-	length_rs = RADCURV * (*t + MPIDIV2 + *v) + *u;
-	return(length_rs);
-}
-
-
-/***********************************************************/
-double csc2_cb(double x, double y, double phi, double rs, double rc, double* t, double *u, double* v)
-{
-	double a, b, u1, theta, length_rs;
-
-	a = x + rs;
-	b = y - rc;
-	u1 = sqrt(a*a + b * b);
-	if (u1 < RADCURVMUL2) return(INFINITY);
-	theta = my_atan2(b, a);
-	*t = mod2pi(theta);
-	*u = u1 - RADCURVMUL2;
-	*v = mod2pi(-*t - MPIDIV2 + phi);
-
-	length_rs = RADCURV * (*t + MPIDIV2 + *v) + *u;
-	return(length_rs);
-}
-
-
-/***********************************************************/
-EXPORT
-double reed_shepp(double x1, double y1, double t1, double x2, double y2, double t2, int* numero, double* tr, double* ur, double* vr)
-{
-	double x, y, phi;
-	double t, u, v, tn, un, vn;
-	int num;
-	double var, vard, theta, alpha, dx, dy, length;
-	double sphi, cphi;
-	double ap, am, b1, b2;
-
-	/* coordinate change */
-	dx = x2 - x1;
-	dy = y2 - y1;
-	theta = my_atan2(dy, dx);
-	alpha = theta - t1;
-	vard = sqrt(dx*dx + dy * dy);
-	x = cos(alpha)*vard;
-	y = sin(alpha)*vard;
-	phi = t2 - t1;
-
-	sphi = sin(phi);
-	cphi = cos(phi);
-
-	ap = RADCURV * sphi;
-	am = -RADCURV * sphi;
-	b1 = RADCURV * (cphi - 1);
-	b2 = RADCURV * (cphi + 1);
-
-	/*   C | C | C   */
-
-	length = c_c_c(x, y, phi, ap, b1, &tn, &un, &vn);
-	num = 1;
-	t = tn; u = un; v = vn;
-
-	var = c_c_c(-x, y, -phi, am, b1, &tn, &un, &vn);
-	if (var < length)
-	{
-		length = var;
-		num = 2;
-		t = tn; u = un; v = vn;
-	}
-
-	var = c_c_c(x, -y, -phi, am, b1, &tn, &un, &vn);
-	if (var < length)
-	{
-		length = var;
-		num = 3;
-		t = tn; u = un; v = vn;
-	}
-
-	var = c_c_c(-x, -y, phi, ap, b1, &tn, &un, &vn);
-	if (var < length)
-	{
-		length = var;
-		num = 4;
-		t = tn; u = un; v = vn;
-	}
-
-	/*   C | C C   */
-
-	var = c_cc(x, y, phi, ap, b1, &tn, &un, &vn);
-	if (var < length)
-	{
-		length = var;
-		num = 5;
-		t = tn; u = un; v = vn;
-	}
-
-	var = c_cc(-x, y, -phi, am, b1, &tn, &un, &vn);
-	if (var < length)
-	{
-		length = var;
-		num = 6;
-		t = tn; u = un; v = vn;
-	}
-
-	var = c_cc(x, -y, -phi, am, b1, &tn, &un, &vn);
-	if (var < length)
-	{
-		length = var;
-		num = 7;
-		t = tn; u = un; v = vn;
-	}
-
-	var = c_cc(-x, -y, phi, ap, b1, &tn, &un, &vn);
-	if (var < length)
-	{
-		length = var;
-		num = 8;
-		t = tn; u = un; v = vn;
-	}
-
-	/*   C S C   */
-
-	var = csca(x, y, phi, ap, b1, &tn, &un, &vn);
-	if (var < length)
-	{
-		length = var;
-		num = 9;
-		t = tn; u = un; v = vn;
-	}
-
-	var = csca(x, -y, -phi, am, b1, &tn, &un, &vn);
-	if (var < length)
-	{
-		length = var;
-		num = 10;
-		t = tn; u = un; v = vn;
-	}
-
-	var = csca(-x, y, -phi, am, b1, &tn, &un, &vn);
-	if (var < length)
-	{
-		length = var;
-		num = 11;
-		t = tn; u = un; v = vn;
-	}
-
-	var = csca(-x, -y, phi, ap, b1, &tn, &un, &vn);
-	if (var < length)
-	{
-		length = var;
-		num = 12;
-		t = tn; u = un; v = vn;
-	}
-
-	var = cscb(x, y, phi, ap, b2, &tn, &un, &vn);
-	if (var < length)
-	{
-		length = var;
-		num = 13;
-		t = tn; u = un; v = vn;
-	}
-
-	var = cscb(x, -y, -phi, am, b2, &tn, &un, &vn);
-	if (var < length)
-	{
-		length = var;
-		num = 14;
-		t = tn; u = un; v = vn;
-	}
-
-	var = cscb(-x, y, -phi, am, b2, &tn, &un, &vn);
-	if (var < length)
-	{
-		length = var;
-		num = 15;
-		t = tn; u = un; v = vn;
-	}
-
-	var = cscb(-x, -y, phi, ap, b2, &tn, &un, &vn);
-	if (var < length)
-	{
-		length = var;
-		num = 16;
-		t = tn; u = un; v = vn;
-	}
-
-	/*   C Cu | Cu C   */
-
-	var = ccu_cuc(x, y, phi, ap, b2, &tn, &un, &vn);
-	if (var < length)
-	{
-		length = var;
-		num = 17;
-		t = tn; u = un; v = vn;
-	}
-
-	var = ccu_cuc(x, -y, -phi, am, b2, &tn, &un, &vn);
-	if (var < length)
-	{
-		length = var;
-		num = 18;
-		t = tn; u = un; v = vn;
-	}
-
-	var = ccu_cuc(-x, y, -phi, am, b2, &tn, &un, &vn);
-	if (var < length)
-	{
-		length = var;
-		num = 19;
-		t = tn; u = un; v = vn;
-	}
-
-	var = ccu_cuc(-x, -y, phi, ap, b2, &tn, &un, &vn);
-	if (var < length)
-	{
-		length = var;
-		num = 20;
-		t = tn; u = un; v = vn;
-	}
-
-	/*   C | Cu Cu | C   */
-
-	var = c_cucu_c(x, y, phi, ap, b2, &tn, &un, &vn);
-	if (var < length)
-	{
-		length = var;
-		num = 21;
-		t = tn; u = un; v = vn;
-	}
-
-	var = c_cucu_c(x, -y, -phi, am, b2, &tn, &un, &vn);
-	if (var < length)
-	{
-		length = var;
-		num = 22;
-		t = tn; u = un; v = vn;
-	}
-
-	var = c_cucu_c(-x, y, -phi, am, b2, &tn, &un, &vn);
-	if (var < length)
-	{
-		length = var;
-		num = 23;
-		t = tn; u = un; v = vn;
-	}
-
-	var = c_cucu_c(-x, -y, phi, ap, b2, &tn, &un, &vn);
-	if (var < length)
-	{
-		length = var;
-		num = 24;
-		t = tn; u = un; v = vn;
-	}
-
-	/*   C | C2 S C   */
-
-	var = c_c2sca(x, y, phi, ap, b1, &tn, &un, &vn);
-	if (var < length)
-	{
-		length = var;
-		num = 25;
-		t = tn; u = un; v = vn;
-	}
-
-	var = c_c2sca(x, -y, -phi, am, b1, &tn, &un, &vn);
-	if (var < length)
-	{
-		length = var;
-		num = 26;
-		t = tn; u = un; v = vn;
-	}
-
-	var = c_c2sca(-x, y, -phi, am, b1, &tn, &un, &vn);
-	if (var < length)
-	{
-		length = var;
-		num = 27;
-		t = tn; u = un; v = vn;
-	}
-
-	var = c_c2sca(-x, -y, phi, ap, b1, &tn, &un, &vn);
-	if (var < length)
-	{
-		length = var;
-		num = 28;
-		t = tn; u = un; v = vn;
-	}
-
-	var = c_c2scb(x, y, phi, ap, b2, &tn, &un, &vn);
-	if (var < length)
-	{
-		length = var;
-		num = 29;
-		t = tn; u = un; v = vn;
-	}
-
-	var = c_c2scb(x, -y, -phi, am, b2, &tn, &un, &vn);
-	if (var < length)
-	{
-		length = var;
-		num = 30;
-		t = tn; u = un; v = vn;
-	}
-
-	var = c_c2scb(-x, y, -phi, am, b2, &tn, &un, &vn);
-	if (var < length)
-	{
-		length = var;
-		num = 31;
-		t = tn; u = un; v = vn;
-	}
-
-	var = c_c2scb(-x, -y, phi, ap, b2, &tn, &un, &vn);
-	if (var < length)
-	{
-		length = var;
-		num = 32;
-		t = tn; u = un; v = vn;
-	}
-
-	/*   C | C2 S C2 | C   */
-
-	var = c_c2sc2_c(x, y, phi, ap, b2, &tn, &un, &vn);
-	if (var < length)
-	{
-		length = var;
-		num = 33;
-		t = tn; u = un; v = vn;
-	}
-
-	var = c_c2sc2_c(x, -y, -phi, am, b2, &tn, &un, &vn);
-	if (var < length)
-	{
-		length = var;
-		num = 34;
-		t = tn; u = un; v = vn;
-	}
-
-	var = c_c2sc2_c(-x, y, -phi, am, b2, &tn, &un, &vn);
-	if (var < length)
-	{
-		length = var;
-		num = 35;
-		t = tn; u = un; v = vn;
-	}
-
-	var = c_c2sc2_c(-x, -y, phi, ap, b2, &tn, &un, &vn);
-	if (var < length)
-	{
-		length = var;
-		num = 36;
-		t = tn; u = un; v = vn;
-	}
-
-	/*   C C | C   */
-
-	var = cc_c(x, y, phi, ap, b1, &tn, &un, &vn);
-	if (var < length)
-	{
-		length = var;
-		num = 37;
-		t = tn; u = un; v = vn;
-	}
-
-	var = cc_c(x, -y, -phi, am, b1, &tn, &un, &vn);
-	if (var < length)
-	{
-		length = var;
-		num = 38;
-		t = tn; u = un; v = vn;
-	}
-
-	var = cc_c(-x, y, -phi, am, b1, &tn, &un, &vn);
-	if (var < length)
-	{
-		length = var;
-		num = 39;
-		t = tn; u = un; v = vn;
-	}
-
-	var = cc_c(-x, -y, phi, ap, b1, &tn, &un, &vn);
-	if (var < length)
-	{
-		length = var;
-		num = 40;
-		t = tn; u = un; v = vn;
-	}
-
-	/*   C S C2 | C   */
-
-	var = csc2_ca(x, y, phi, ap, b1, &tn, &un, &vn);
-	if (var < length)
-	{
-		length = var;
-		num = 41;
-		t = tn; u = un; v = vn;
-	}
-
-	var = csc2_ca(x, -y, -phi, am, b1, &tn, &un, &vn);
-	if (var < length)
-	{
-		length = var;
-		num = 42;
-		t = tn; u = un; v = vn;
-	}
-
-	var = csc2_ca(-x, y, -phi, am, b1, &tn, &un, &vn);
-	if (var < length)
-	{
-		length = var;
-		num = 43;
-		t = tn; u = un; v = vn;
-	}
-
-	var = csc2_ca(-x, -y, phi, ap, b1, &tn, &un, &vn);
-	if (var < length)
-	{
-		length = var;
-		num = 44;
-		t = tn; u = un; v = vn;
-	}
-
-	var = csc2_cb(x, y, phi, ap, b2, &tn, &un, &vn);
-	if (var < length)
-	{
-		length = var;
-		num = 45;
-		t = tn; u = un; v = vn;
-	}
-
-	var = csc2_cb(x, -y, -phi, am, b2, &tn, &un, &vn);
-	if (var < length)
-	{
-		length = var;
-		num = 46;
-		t = tn; u = un; v = vn;
-	}
-
-	var = csc2_cb(-x, y, -phi, am, b2, &tn, &un, &vn);
-	if (var < length)
-	{
-		length = var;
-		num = 47;
-		t = tn; u = un; v = vn;
-	}
-
-	var = csc2_cb(-x, -y, phi, ap, b2, &tn, &un, &vn);
-	if (var < length)
-	{
-		length = var;
-		num = 48;
-		t = tn; u = un; v = vn;
-	}
-
-
-
-
-
-
-	*tr = t; *ur = u; *vr = v;
-	*numero = num;
-	return(length);
-}
-
-
-/***********************************************************/
-double min_length_rs(double x1, double y1, double t1, double x2, double y2, double t2, int* numero, double* t, double* u, double* v)
-{
-	double length_rs;
-
-	if ((fabs(x1 - x2)<EPS1) && (fabs(y1 - y2)<EPS1)
-		&& (fabs(t1 - t2)<EPS1))  length_rs = 0.0;
-	else length_rs = reed_shepp(x1, y1, t1, x2, y2, t2, numero, t, u, v);
-
-	return(length_rs);
-}
-
-
-/***********************************************************/
-int fct_curve(int ty, int orientation, double val, double* x1, double* y1, double* t1, double delta, double* pathx, double* pathy, double* patht, int n)
-{
-	int i;
-	double va1, va2, l, newval, incrt, remain;
-	double center_x, center_y;
-	double x2, y2, t2;
-	int nnew;
-
-	if (ty == 3)
-		if (fabs(val / RADCURV)<EPS4) return(0);
-	else
-		if (fabs(val)<EPS4) return(0);
-
-	switch (ty)
-	{
-	case 1: /* circular arc toward the right */
-		center_x = *x1 + RADCURV * sin(*t1);
-		center_y = *y1 - RADCURV * cos(*t1);
-		va1 = *t1 + MPIDIV2;
-		if (orientation == 1) va2 = va1 - val;
-		else va2 = va1 + val;
-		x2 = center_x + RADCURV * cos(va2);
-		y2 = center_y + RADCURV * sin(va2);
-		t2 = *t1 - orientation * val;
-
-		nnew = val / delta;
-		remain = val - nnew * delta;
-		nnew = nnew + n;
-
-		if (orientation == -1) delta = -delta;
-		incrt = 0;
-		for (i = n; i<nnew; i++)
-		{
-			va1 = va1 - delta;
-			*(pathx + i) = center_x + RADCURV * cos(va1);
-			*(pathy + i) = center_y + RADCURV * sin(va1);
-			incrt = incrt - delta;
-			*(patht + i) = mod2pi(*t1 + incrt);
-		}
-		n = nnew;
-		if (remain > fabs(delta) / 5.)
-		{
-			*(pathx + nnew) = x2;
-			*(pathy + nnew) = y2;
-			*(patht + nnew) = mod2pi(t2);
-			n++;
-		}
-		else
-		{
-			*(pathx + nnew - 1) = x2;
-			*(pathy + nnew - 1) = y2;
-			*(patht + nnew - 1) = mod2pi(t2);
-		}
-		break;
-
-	case 2: /* circular arc toward the left */
-		center_x = *x1 - RADCURV * sin(*t1);
-		center_y = *y1 + RADCURV * cos(*t1);
-		va1 = *t1 - MPIDIV2;
-		if (orientation == 1) va2 = va1 + val;
-		else va2 = va1 - val;
-		x2 = center_x + RADCURV * cos(va2);
-		y2 = center_y + RADCURV * sin(va2);
-		t2 = *t1 + orientation * val;
-
-		nnew = val / delta;
-		remain = val - nnew * delta;
-		nnew = nnew + n;
-
-		if (orientation == -1) delta = -delta;
-		incrt = 0;
-		for (i = n; i<nnew; i++)
-		{
-			va1 = va1 + delta;
-			*(pathx + i) = center_x + RADCURV * cos(va1);
-			*(pathy + i) = center_y + RADCURV * sin(va1);
-			incrt = incrt + delta;
-			*(patht + i) = mod2pi(*t1 + incrt);
-		}
-		n = nnew;
-		if (remain > fabs(delta) / 5.)
-		{
-			*(pathx + nnew) = x2;
-			*(pathy + nnew) = y2;
-			*(patht + nnew) = mod2pi(t2);
-			n++;
-		}
-		else
-		{
-			*(pathx + nnew - 1) = x2;
-			*(pathy + nnew - 1) = y2;
-			*(patht + nnew - 1) = mod2pi(t2);
-		}
-		break;
-
-	case 3: /* straight line */
-		x2 = *x1 + orientation * val*cos(*t1);
-		y2 = *y1 + orientation * val*sin(*t1);
-		*t1 = mod2pi(*t1);
-		t2 = *t1;
-
-		va1 = sqrt((x2 - *x1)*(x2 - *x1) + (y2 - *y1)*(y2 - *y1));
-		i = va1 / 1.2;
-		remain = va1 - i * 1.2;
-		nnew = n + i;
-		newval = 1.2;
-		va1 = orientation * cos(*t1);
-		va2 = orientation * sin(*t1);
-		for (i = n; i<nnew; i++)
-		{
-			*(pathx + i) = *x1 + va1 * newval;
-			*(pathy + i) = *y1 + va2 * newval;
-			*(patht + i) = *t1;
-			newval = newval + 1.2;
-		}
-		if (remain > 0.4)
-		{
-			*(pathx + nnew) = x2;
-			*(pathy + nnew) = y2;
-			*(patht + nnew) = t2;
-			n = nnew + 1;
-		}
-		else
-		{
-			*(pathx + nnew - 1) = x2;
-			*(pathy + nnew - 1) = y2;
-			*(patht + nnew - 1) = t2;
-			n = nnew;
-		}
-	}
-
-	*x1 = x2;
-	*y1 = y2;
-	*t1 = t2;
-
-	return(n);
-}
-
-
-/***********************************************************/
-EXPORT
-int constRS(int num, double t, double u, double v, double x1, double y1, double t1, double delta, double* pathx, double* pathy, double* patht)
-{
-	int left, right, straight, fwd, bwd;
-	int n;
-
-	*pathx = x1;
-	*pathy = y1;
-	*patht = t1;
-	n = 1;
-
-	right = 1; left = 2; straight = 3;
-	fwd = 1; bwd = -1;
-
-	switch (num)
-	{
-
-		/*   C | C | C   */
-
-	case 1:
-		n = fct_curve(left, fwd, t, &x1, &y1, &t1, delta, pathx, pathy, patht, 1);
-		n = fct_curve(right, bwd, u, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		n = fct_curve(left, fwd, v, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		break;
-
-	case 2:
-		n = fct_curve(left, bwd, t, &x1, &y1, &t1, delta, pathx, pathy, patht, 1);
-		n = fct_curve(right, fwd, u, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		n = fct_curve(left, bwd, v, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		break;
-
-	case 3:
-		n = fct_curve(right, fwd, t, &x1, &y1, &t1, delta, pathx, pathy, patht, 1);
-		n = fct_curve(left, bwd, u, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		n = fct_curve(right, fwd, v, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		break;
-
-	case 4:
-		n = fct_curve(right, bwd, t, &x1, &y1, &t1, delta, pathx, pathy, patht, 1);
-		n = fct_curve(left, fwd, u, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		n = fct_curve(right, bwd, v, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		break;
-
-		/*   C | C C   */
-
-	case 5:
-		n = fct_curve(left, fwd, t, &x1, &y1, &t1, delta, pathx, pathy, patht, 1);
-		n = fct_curve(right, bwd, u, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		n = fct_curve(left, bwd, v, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		break;
-
-	case 6:
-		n = fct_curve(left, bwd, t, &x1, &y1, &t1, delta, pathx, pathy, patht, 1);
-		n = fct_curve(right, fwd, u, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		n = fct_curve(left, fwd, v, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		break;
-
-	case 7:
-		n = fct_curve(right, fwd, t, &x1, &y1, &t1, delta, pathx, pathy, patht, 1);
-		n = fct_curve(left, bwd, u, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		n = fct_curve(right, bwd, v, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		break;
-
-	case 8:
-		n = fct_curve(right, bwd, t, &x1, &y1, &t1, delta, pathx, pathy, patht, 1);
-		n = fct_curve(left, fwd, u, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		n = fct_curve(right, fwd, v, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		break;
-
-		/*   C S C   */
-
-	case 9:
-		n = fct_curve(left, fwd, t, &x1, &y1, &t1, delta, pathx, pathy, patht, 1);
-		n = fct_curve(straight, fwd, u, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		n = fct_curve(left, fwd, v, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		break;
-
-	case 10:
-		n = fct_curve(right, fwd, t, &x1, &y1, &t1, delta, pathx, pathy, patht, 1);
-		n = fct_curve(straight, fwd, u, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		n = fct_curve(right, fwd, v, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		break;
-
-	case 11:
-		n = fct_curve(left, bwd, t, &x1, &y1, &t1, delta, pathx, pathy, patht, 1);
-		n = fct_curve(straight, bwd, u, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		n = fct_curve(left, bwd, v, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		break;
-
-	case 12:
-		n = fct_curve(right, bwd, t, &x1, &y1, &t1, delta, pathx, pathy, patht, 1);
-		n = fct_curve(straight, bwd, u, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		n = fct_curve(right, bwd, v, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		break;
-
-	case 13:
-		n = fct_curve(left, fwd, t, &x1, &y1, &t1, delta, pathx, pathy, patht, 1);
-		n = fct_curve(straight, fwd, u, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		n = fct_curve(right, fwd, v, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		break;
-
-	case 14:
-		n = fct_curve(right, fwd, t, &x1, &y1, &t1, delta, pathx, pathy, patht, 1);
-		n = fct_curve(straight, fwd, u, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		n = fct_curve(left, fwd, v, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		break;
-
-	case 15:
-		n = fct_curve(left, bwd, t, &x1, &y1, &t1, delta, pathx, pathy, patht, 1);
-		n = fct_curve(straight, bwd, u, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		n = fct_curve(right, bwd, v, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		break;
-
-	case 16:
-		n = fct_curve(right, bwd, t, &x1, &y1, &t1, delta, pathx, pathy, patht, 1);
-		n = fct_curve(straight, bwd, u, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		n = fct_curve(left, bwd, v, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		break;
-
-		/*   C Cu | Cu C   */
-
-	case 17:
-		n = fct_curve(left, fwd, t, &x1, &y1, &t1, delta, pathx, pathy, patht, 1);
-		n = fct_curve(right, fwd, u, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		n = fct_curve(left, bwd, u, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		n = fct_curve(right, bwd, v, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		break;
-
-	case 18:
-		n = fct_curve(right, fwd, t, &x1, &y1, &t1, delta, pathx, pathy, patht, 1);
-		n = fct_curve(left, fwd, u, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		n = fct_curve(right, bwd, u, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		n = fct_curve(left, bwd, v, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		break;
-
-	case 19:
-		n = fct_curve(left, bwd, t, &x1, &y1, &t1, delta, pathx, pathy, patht, 1);
-		n = fct_curve(right, bwd, u, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		n = fct_curve(left, fwd, u, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		n = fct_curve(right, fwd, v, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		break;
-
-	case 20:
-		n = fct_curve(right, bwd, t, &x1, &y1, &t1, delta, pathx, pathy, patht, 1);
-		n = fct_curve(left, bwd, u, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		n = fct_curve(right, fwd, u, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		n = fct_curve(left, fwd, v, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		break;
-
-		/*   C | Cu Cu | C   */
-
-	case 21:
-		n = fct_curve(left, fwd, t, &x1, &y1, &t1, delta, pathx, pathy, patht, 1);
-		n = fct_curve(right, bwd, u, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		n = fct_curve(left, bwd, u, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		n = fct_curve(right, fwd, v, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		break;
-
-	case 22:
-		n = fct_curve(right, fwd, t, &x1, &y1, &t1, delta, pathx, pathy, patht, 1);
-		n = fct_curve(left, bwd, u, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		n = fct_curve(right, bwd, u, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		n = fct_curve(left, fwd, v, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		break;
-
-	case 23:
-		n = fct_curve(left, bwd, t, &x1, &y1, &t1, delta, pathx, pathy, patht, 1);
-		n = fct_curve(right, fwd, u, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		n = fct_curve(left, fwd, u, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		n = fct_curve(right, bwd, v, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		break;
-
-	case 24:
-		n = fct_curve(right, bwd, t, &x1, &y1, &t1, delta, pathx, pathy, patht, 1);
-		n = fct_curve(left, fwd, u, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		n = fct_curve(right, fwd, u, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		n = fct_curve(left, bwd, v, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		break;
-
-		/*   C | C2 S C   */
-
-	case 25:
-		n = fct_curve(left, fwd, t, &x1, &y1, &t1, delta, pathx, pathy, patht, 1);
-		n = fct_curve(right, bwd, MPIDIV2, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		n = fct_curve(straight, bwd, u, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		n = fct_curve(left, bwd, v, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		break;
-
-	case 26:
-		n = fct_curve(right, fwd, t, &x1, &y1, &t1, delta, pathx, pathy, patht, 1);
-		n = fct_curve(left, bwd, MPIDIV2, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		n = fct_curve(straight, bwd, u, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		n = fct_curve(right, bwd, v, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		break;
-
-	case 27:
-		n = fct_curve(left, bwd, t, &x1, &y1, &t1, delta, pathx, pathy, patht, 1);
-		n = fct_curve(right, fwd, MPIDIV2, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		n = fct_curve(straight, fwd, u, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		n = fct_curve(left, fwd, v, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		break;
-
-	case 28:
-		n = fct_curve(right, bwd, t, &x1, &y1, &t1, delta, pathx, pathy, patht, 1);
-		n = fct_curve(left, fwd, MPIDIV2, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		n = fct_curve(straight, fwd, u, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		n = fct_curve(right, fwd, v, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		break;
-
-	case 29:
-		n = fct_curve(left, fwd, t, &x1, &y1, &t1, delta, pathx, pathy, patht, 1);
-		n = fct_curve(right, bwd, MPIDIV2, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		n = fct_curve(straight, bwd, u, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		n = fct_curve(right, bwd, v, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		break;
-
-	case 30:
-		n = fct_curve(right, fwd, t, &x1, &y1, &t1, delta, pathx, pathy, patht, 1);
-		n = fct_curve(left, bwd, MPIDIV2, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		n = fct_curve(straight, bwd, u, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		n = fct_curve(left, bwd, v, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		break;
-
-	case 31:
-		n = fct_curve(left, bwd, t, &x1, &y1, &t1, delta, pathx, pathy, patht, 1);
-		n = fct_curve(right, fwd, MPIDIV2, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		n = fct_curve(straight, fwd, u, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		n = fct_curve(right, fwd, v, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		break;
-
-	case 32:
-		n = fct_curve(right, bwd, t, &x1, &y1, &t1, delta, pathx, pathy, patht, 1);
-		n = fct_curve(left, fwd, MPIDIV2, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		n = fct_curve(straight, fwd, u, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		n = fct_curve(left, fwd, v, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		break;
-
-		/*   C | C2 S C2 | C   */
-
-	case 33:
-		n = fct_curve(left, fwd, t, &x1, &y1, &t1, delta, pathx, pathy, patht, 1);
-		n = fct_curve(right, bwd, MPIDIV2, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		n = fct_curve(straight, bwd, u, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		n = fct_curve(left, bwd, MPIDIV2, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		n = fct_curve(right, fwd, v, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		break;
-
-	case 34:
-		n = fct_curve(right, fwd, t, &x1, &y1, &t1, delta, pathx, pathy, patht, 1);
-		n = fct_curve(left, bwd, MPIDIV2, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		n = fct_curve(straight, bwd, u, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		n = fct_curve(right, bwd, MPIDIV2, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		n = fct_curve(left, fwd, v, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		break;
-
-	case 35:
-		n = fct_curve(left, bwd, t, &x1, &y1, &t1, delta, pathx, pathy, patht, 1);
-		n = fct_curve(right, fwd, MPIDIV2, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		n = fct_curve(straight, fwd, u, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		n = fct_curve(left, fwd, MPIDIV2, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		n = fct_curve(right, bwd, v, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		break;
-
-	case 36:
-		n = fct_curve(right, bwd, t, &x1, &y1, &t1, delta, pathx, pathy, patht, 1);
-		n = fct_curve(left, fwd, MPIDIV2, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		n = fct_curve(straight, fwd, u, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		n = fct_curve(right, fwd, MPIDIV2, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		n = fct_curve(left, bwd, v, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		break;
-
-		/*   C C | C   */
-
-	case 37:
-		n = fct_curve(left, fwd, t, &x1, &y1, &t1, delta, pathx, pathy, patht, 1);
-		n = fct_curve(right, fwd, u, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		n = fct_curve(left, bwd, v, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		break;
-
-	case 38:
-		n = fct_curve(right, fwd, t, &x1, &y1, &t1, delta, pathx, pathy, patht, 1);
-		n = fct_curve(left, fwd, u, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		n = fct_curve(right, bwd, v, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		break;
-
-	case 39:
-		n = fct_curve(left, bwd, t, &x1, &y1, &t1, delta, pathx, pathy, patht, 1);
-		n = fct_curve(right, bwd, u, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		n = fct_curve(left, fwd, v, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		break;
-
-	case 40:
-		n = fct_curve(right, bwd, t, &x1, &y1, &t1, delta, pathx, pathy, patht, 1);
-		n = fct_curve(left, bwd, u, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		n = fct_curve(right, fwd, v, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		break;
-
-		/*   C S C2 | C   */
-
-	case 41:
-		n = fct_curve(left, fwd, t, &x1, &y1, &t1, delta, pathx, pathy, patht, 1);
-		n = fct_curve(straight, fwd, u, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		n = fct_curve(right, fwd, MPIDIV2, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		n = fct_curve(left, bwd, v, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		break;
-
-	case 42:
-		n = fct_curve(right, fwd, t, &x1, &y1, &t1, delta, pathx, pathy, patht, 1);
-		n = fct_curve(straight, fwd, u, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		n = fct_curve(left, fwd, MPIDIV2, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		n = fct_curve(right, bwd, v, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		break;
-
-	case 43:
-		n = fct_curve(left, bwd, t, &x1, &y1, &t1, delta, pathx, pathy, patht, 1);
-		n = fct_curve(straight, bwd, u, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		n = fct_curve(right, bwd, MPIDIV2, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		n = fct_curve(left, fwd, v, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		break;
-
-	case 44:
-		n = fct_curve(right, bwd, t, &x1, &y1, &t1, delta, pathx, pathy, patht, 1);
-		n = fct_curve(straight, bwd, u, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		n = fct_curve(left, bwd, MPIDIV2, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		n = fct_curve(right, fwd, v, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		break;
-
-	case 45:
-		n = fct_curve(left, fwd, t, &x1, &y1, &t1, delta, pathx, pathy, patht, 1);
-		n = fct_curve(straight, fwd, u, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		n = fct_curve(left, fwd, MPIDIV2, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		n = fct_curve(right, bwd, v, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		break;
-
-	case 46:
-		n = fct_curve(right, fwd, t, &x1, &y1, &t1, delta, pathx, pathy, patht, 1);
-		n = fct_curve(straight, fwd, u, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		n = fct_curve(right, fwd, MPIDIV2, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		n = fct_curve(left, bwd, v, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		break;
-
-	case 47:
-		n = fct_curve(left, bwd, t, &x1, &y1, &t1, delta, pathx, pathy, patht, 1);
-		n = fct_curve(straight, bwd, u, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		n = fct_curve(left, bwd, MPIDIV2, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		n = fct_curve(right, fwd, v, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		break;
-
-	case 48:
-		n = fct_curve(right, bwd, t, &x1, &y1, &t1, delta, pathx, pathy, patht, 1);
-		n = fct_curve(straight, bwd, u, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		n = fct_curve(right, bwd, MPIDIV2, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		n = fct_curve(left, fwd, v, &x1, &y1, &t1, delta, pathx, pathy, patht, n);
-		break;
-
-
-
-	default:
-		printf("Error: RS curve type %d unknown\n", num);
-	}
-
-	return n;
-}
+// ReedAndSheppDll.cpp : définit les fonctions exportées pour l'application DLL.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "ReedAndShepp.h"
+#include "ReedAndShepp_internal.h"
+
+#define RS_MATH_SCALAR
+#include "ReedAndShepp_math.h"
+#define RS_KERNEL
+#include "ReedAndShepp_kernels.h"
+
+static void rs_solve_scalar(const rs_context* ctx, int n, const double* x, const double* y, const double* phi,
+	double* length, int* numero, double* tr, double* ur, double* vr);
+static void rs_solve_f_scalar(const rs_context* ctx, int n, const float* x, const float* y, const float* phi,
+	float* length, int* numero, float* tr, float* ur, float* vr);
+static void rs_stats_solve(const rs_context* ctx, int n, const double* x, const double* y, const double* phi,
+	const int* numero, unsigned long long cycles);
+
+/*
+
+rs_solve_one is the scan of the RS curves used by reed_shepp, and
+rs_solve_many the one used by reed_shepp_batch. The initializer sets them
+to the fastest versions supported by the CPU. A single query only fills
+half of an AVX-512 vector, so reed_shepp stops at AVX2. The environment
+variable RS_ISA (scalar, sse42, avx2 or avx512) lowers the choice.
+rs_solve_f_one and rs_solve_f_many are the same in single precision, where
+a query fills an SSE4.2 vector.
+
+*/
+
+static rs_solve_fn rs_solve_one = rs_solve_scalar;
+static rs_solve_fn rs_solve_many = rs_solve_scalar;
+static rs_solve_f_fn rs_solve_f_one = rs_solve_f_scalar;
+static rs_solve_f_fn rs_solve_f_many = rs_solve_f_scalar;
+static const char* rs_isa_name = "scalar";
+
+#ifdef RS_DISPATCH
+void rs_select_isa(const char* wanted)
+{
+	static const char* names[4] = { "scalar", "sse42", "avx2", "avx512" };
+	static const rs_solve_fn solvers[4] = { rs_solve_scalar, rs_solve_sse42, rs_solve_avx2, rs_solve_avx512 };
+	static const rs_solve_f_fn solvers_f[4] = { rs_solve_f_scalar, rs_solve_f_sse42, rs_solve_f_avx2, rs_solve_f_avx512 };
+	int level, i;
+
+	level = 0;
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("sse4.2")) level = 1;
+	if ((level == 1) && __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) level = 2;
+	if ((level == 2) && __builtin_cpu_supports("avx512f")) level = 3;
+
+	if (wanted != NULL)
+		for (i = 0; i < level; i++)
+			if (strcmp(wanted, names[i]) == 0) level = i;
+
+	rs_solve_many = solvers[level];
+	rs_solve_one = solvers[(level < 2) ? level : 2];
+	rs_solve_f_many = solvers_f[level];
+	rs_solve_f_one = solvers_f[(level < 1) ? level : 1];
+	rs_isa_name = names[level];
+}
+#endif
+
+// Initializer.
+__attribute__((constructor))
+static void initializer(void) {                             // 2
+#ifdef RS_DISPATCH
+	rs_select_isa(getenv("RS_ISA"));
+#endif
+}
+ 
+// Finalizer.
+__attribute__((destructor))
+static void finalizer(void) {                               // 3
+}
+
+/*
+
+The functions c_c_c through cs2_cb compute the lengths of the RS curves, for
+a certain increment of configuration (x,y,phi) computed in the function
+reed-shepp. They are in ReedAndShepp_kernels.h, shared with
+ReedAndShepp.hpp.
+
+The function reed-shepp computes the increment between two configurations and
+scans all RS curves to determine the shortest one. It is called through the
+function min_length_rs to avoid a too small increment (which could yield
+numerical errors).
+
+The function reed_shepp_batch does the same as reed-shepp for many pairs
+of configurations at once, given as arrays.
+
+The turning radius and its derived constants are read from an rs_context
+passed down to every function. The exported functions ending in _ctx
+take it from the caller, the other ones use rs_default, set by
+change_radcurv.
+
+The function constRS computes the discretized path (in pathx, pathy,
+and patht) of the RS curve number NUM, parameters t, u and v, starting
+at (x1,y1,t1).  It calls fct_curve that computes the path for a right
+circular arc, left circular atc, and straight line. The discretization
+done in fct-curve is rather ugly, and you could rewrite this function.
+
+
+
+What is the significance of the parameters to reed_shepp() ?
+
+From the brief description of the RS curves given in HO 9 you can
+gather that RS curves consist of 3 to 5 segments (straight segments
+and/or circular arcs). However, at most 3 have unpredetermined
+lengths.  The parameters tr, ur, vr are intended to contain these
+lengths.  For example, the first call in the function reed_shepp() is
+to c_c_c(). The pointers to tn, un, and vn are passed to c_c_c(),
+which computes the length of the 3 circular arcs of this RS curve. At
+the end, reed_shepp puts in tr, ur, and vr the parameters
+corresponding to the shortest RS curves found.  The unit of length for
+a straight segment is whatever you want.  For a circular arc it is in
+radians.
+
+The parameter numero is just the number identifying a RS curve.  The
+value given at the end of reed-shepp is the number (1 to 48)
+identifying the shortes RS curve found between the two given
+configurations.
+
+
+*/
+
+/*
+rs_default is the context of the functions that do not take one. It is
+the only state shared between calls, and only change_radcurv,
+change_sampling and change_scan write it.
+*/
+rs_context rs_default = { 1.0, 2.0, 4.0, 1.0, 4.0, RS_SAMPLING_LEGACY, RS_SCAN_FULL };
+
+static void rs_context_init(rs_context* ctx, double radcurv)
+{
+	ctx->radcurv = radcurv;
+	ctx->radcurvmul2 = 2 * radcurv;
+	ctx->radcurvmul4 = 4 * radcurv;
+	ctx->sqradcurv = radcurv * radcurv;
+	ctx->sqradcurvmul2 = 4 * radcurv * radcurv;
+}
+
+EXPORT
+void change_radcurv(double radcurv)
+{
+	rs_context_init(&rs_default, radcurv);
+}
+
+EXPORT
+rs_context* rs_context_create(double radcurv)
+{
+	rs_context* ctx;
+
+	ctx = (rs_context*)malloc(sizeof(rs_context));
+	if (ctx != NULL)
+	{
+		rs_context_init(ctx, radcurv);
+		ctx->sampling = RS_SAMPLING_LEGACY;
+		ctx->scan = RS_SCAN_FULL;
+	}
+	return(ctx);
+}
+
+EXPORT
+void rs_context_set_sampling(rs_context* ctx, int sampling)
+{
+	ctx->sampling = sampling;
+}
+
+EXPORT
+void change_sampling(int sampling)
+{
+	rs_context_set_sampling(&rs_default, sampling);
+}
+
+EXPORT
+void rs_context_set_scan(rs_context* ctx, int scan)
+{
+	ctx->scan = scan;
+}
+
+EXPORT
+void change_scan(int scan)
+{
+	rs_context_set_scan(&rs_default, scan);
+}
+
+EXPORT
+void rs_context_destroy(rs_context* ctx)
+{
+	free(ctx);
+}
+
+/***********************************************************/
+double mod2pi(double angle)
+{
+	return(rs_mod2pi(angle));
+}
+
+
+/***********************************************************/
+double my_atan2(double y, double x)
+{
+	return(rs_atan2(y, x));
+}
+
+
+/***********************************************************/
+EXPORT
+const char* rs_isa(void)
+{
+	return(rs_isa_name);
+}
+
+
+/***********************************************************/
+EXPORT
+double reed_shepp_ctx(const rs_context* ctx, double x1, double y1, double t1, double x2, double y2, double t2, int* numero, double* tr, double* ur, double* vr)
+{
+	double x, y, phi, dx, dy, ct, st, length;
+	unsigned long long start;
+	rs_solve_fn solve;
+
+	/* coordinate change */
+	dx = x2 - x1;
+	dy = y2 - y1;
+	ct = cos(t1);
+	st = sin(t1);
+	x = dx * ct + dy * st;
+	y = dy * ct - dx * st;
+	phi = t2 - t1;
+
+	solve = (ctx->scan == RS_SCAN_CANONICAL) ? rs_solve_scalar : rs_solve_one;
+	if (__atomic_load_n(&rs_stats_enabled, __ATOMIC_RELAXED))
+	{
+		start = rs_stats_clock();
+		solve(ctx, 1, &x, &y, &phi, &length, numero, tr, ur, vr);
+		rs_stats_solve(ctx, 1, &x, &y, &phi, numero, rs_stats_clock() - start);
+	}
+	else solve(ctx, 1, &x, &y, &phi, &length, numero, tr, ur, vr);
+	return(length);
+}
+
+
+/***********************************************************/
+EXPORT
+double reed_shepp(double x1, double y1, double t1, double x2, double y2, double t2, int* numero, double* tr, double* ur, double* vr)
+{
+	return(reed_shepp_ctx(&rs_default, x1, y1, t1, x2, y2, t2, numero, tr, ur, vr));
+}
+
+
+/***********************************************************/
+/*
+reed_shepp_batch solves n queries given as structure-of-arrays. Query i
+goes from (x1[i],y1[i],t1[i]) to (x2[i],y2[i],t2[i]) and its results are
+written to length[i], numero[i], tr[i], ur[i] and vr[i], exactly as
+reed_shepp would. The coordinate change is done a block at a time in a
+branch-free loop so that the compiler can vectorize it.
+*/
+#define RS_BATCH_BLOCK 64
+
+EXPORT
+void reed_shepp_batch_ctx(const rs_context* ctx, int n, const double* x1, const double* y1, const double* t1, const double* x2, const double* y2, const double* t2,
+	double* length, int* numero, double* tr, double* ur, double* vr)
+{
+	double x[RS_BATCH_BLOCK], y[RS_BATCH_BLOCK], phi[RS_BATCH_BLOCK];
+	double dx, dy, ct, st;
+	unsigned long long start;
+	rs_solve_fn solve;
+	int i, j, m;
+
+	solve = (ctx->scan == RS_SCAN_CANONICAL) ? rs_solve_scalar : rs_solve_many;
+	for (i = 0; i < n; i += RS_BATCH_BLOCK)
+	{
+		m = (n - i < RS_BATCH_BLOCK) ? n - i : RS_BATCH_BLOCK;
+
+		/* coordinate change */
+		for (j = 0; j < m; j++)
+		{
+			dx = x2[i + j] - x1[i + j];
+			dy = y2[i + j] - y1[i + j];
+			ct = cos(t1[i + j]);
+			st = sin(t1[i + j]);
+			x[j] = dx * ct + dy * st;
+			y[j] = dy * ct - dx * st;
+			phi[j] = t2[i + j] - t1[i + j];
+		}
+
+		if (__atomic_load_n(&rs_stats_enabled, __ATOMIC_RELAXED))
+		{
+			start = rs_stats_clock();
+			solve(ctx, m, x, y, phi, length + i, numero + i, tr + i, ur + i, vr + i);
+			rs_stats_solve(ctx, m, x, y, phi, numero + i, rs_stats_clock() - start);
+		}
+		else solve(ctx, m, x, y, phi, length + i, numero + i, tr + i, ur + i, vr + i);
+	}
+}
+
+
+/***********************************************************/
+EXPORT
+void reed_shepp_batch(int n, const double* x1, const double* y1, const double* t1, const double* x2, const double* y2, const double* t2,
+	double* length, int* numero, double* tr, double* ur, double* vr)
+{
+	reed_shepp_batch_ctx(&rs_default, n, x1, y1, t1, x2, y2, t2, length, numero, tr, ur, vr);
+}
+
+
+/***********************************************************/
+/*
+The functions lb_* give, without any inverse trigonometric function, a
+lower bound of the length computed by the RS curves functions for the
+same arguments, or INFINITY when these return INFINITY anyway. They
+repeat the range checks on u1 done at the beginning of the curves
+functions and bound the length from:
+- the straight segment and the arcs of fixed length (MPIDIV2 or MPI),
+- the arcs t, u and v: each curve function computes v so that a sum or
+  a difference of t, u and v is equal to phi (plus some fixed angle)
+  modulo 2 pi, which bounds t + u + v from below,
+- u >= u1 / (2 * radcurv) for C|C|C, C|CC and CC|C.
+*/
+
+/* smallest absolute value of the angles equal to angle modulo 2 pi */
+static double abs_angle(double angle)
+{
+	angle = mod2pi(angle);
+	return((angle > MPI) ? MPIMUL2 - angle : angle);
+}
+
+
+static double lb_csca(const rs_context* ctx, double x, double y, double phi, double rs, double rc)
+{
+	double a, b;
+
+	a = x - rs;
+	b = y + rc;
+	return(ctx->radcurv * mod2pi(phi) + sqrt(a*a + b * b));
+}
+
+
+static double lb_cscb(const rs_context* ctx, double x, double y, double phi, double rs, double rc)
+{
+	double a, b, u1;
+
+	a = x + rs;
+	b = y - rc;
+	u1 = sqrt(a*a + b * b);
+	if (u1 < ctx->radcurvmul2) return(INFINITY);
+	return(ctx->radcurv * abs_angle(phi) + sqrt(u1*u1 - ctx->sqradcurvmul2));
+}
+
+
+static double lb_c2sca(const rs_context* ctx, double x, double y, double phi, double rs, double rc)
+{
+	double a, b, u1, u;
+
+	a = x - rs;
+	b = y + rc;
+	u1 = sqrt(a*a + b * b);
+	if (u1 < ctx->radcurvmul2) return(INFINITY);
+	u = sqrt(u1*u1 - ctx->sqradcurvmul2) - ctx->radcurvmul2;
+	if (u < 0.0) return(INFINITY);
+	return(ctx->radcurv * (MPIDIV2 + abs_angle(MPIDIV2 - phi)) + u);
+}
+
+
+/* c_c2scb and csc2_cb */
+static double lb_c2scb(const rs_context* ctx, double x, double y, double phi, double rs, double rc)
+{
+	double a, b, u1;
+
+	a = x + rs;
+	b = y - rc;
+	u1 = sqrt(a*a + b * b);
+	if (u1 < ctx->radcurvmul2) return(INFINITY);
+	return(ctx->radcurv * (MPIDIV2 + mod2pi(phi - MPIDIV2)) + u1 - ctx->radcurvmul2);
+}
+
+
+static double lb_c2sc2_c(const rs_context* ctx, double x, double y, double phi, double rs, double rc)
+{
+	double a, b, u1, u;
+
+	a = x + rs;
+	b = y - rc;
+	u1 = sqrt(a*a + b * b);
+	if (u1 < ctx->radcurvmul4) return(INFINITY);
+	u = sqrt(u1*u1 - ctx->sqradcurvmul2) - ctx->radcurvmul4;
+	if (u < 0.0) return(INFINITY);
+	return(ctx->radcurv * (MPI + abs_angle(phi)) + u);
+}
+
+
+static double lb_csc2_ca(const rs_context* ctx, double x, double y, double phi, double rs, double rc)
+{
+	double a, b, u1, u;
+
+	a = x - rs;
+	b = y + rc;
+	u1 = sqrt(a*a + b * b);
+	if (u1 < ctx->radcurvmul2) return(INFINITY);
+	u = sqrt(u1*u1 - ctx->sqradcurvmul2) - ctx->radcurvmul2;
+	if (u < 0.0) return(INFINITY);
+	return(ctx->radcurv * (MPIDIV2 + abs_angle(MPIDIV2 + phi)) + u);
+}
+
+
+/* c_c_c: t + u + v = phi modulo 2 pi, and u <= MPI */
+static double lb_c_c_c(const rs_context* ctx, double x, double y, double phi, double rs, double rc)
+{
+	double a, b, u1, turn;
+
+	a = x - rs;
+	b = y + rc;
+	if ((fabs(a)<EPS3) && (fabs(b)<EPS3)) return(INFINITY);
+	u1 = sqrt(a*a + b * b);
+	if (u1>ctx->radcurvmul4) return(INFINITY);
+	turn = mod2pi(phi);
+	if (ctx->radcurv * turn < u1 / 2) turn = turn + MPIMUL2;
+	return(ctx->radcurv * turn);
+}
+
+
+/* c_cc and cc_c */
+static double lb_c_cc(const rs_context* ctx, double x, double y, double phi, double rs, double rc)
+{
+	double a, b, u1, turn;
+
+	a = x - rs;
+	b = y + rc;
+	if ((fabs(a)<EPS3) && (fabs(b)<EPS3)) return(INFINITY);
+	u1 = sqrt(a*a + b * b);
+	if (u1>ctx->radcurvmul4) return(INFINITY);
+	turn = ctx->radcurv * abs_angle(phi);
+	return((turn > u1 / 2) ? turn : u1 / 2);
+}
+
+
+static double lb_ccu_cuc(const rs_context* ctx, double x, double y, double phi, double rs, double rc)
+{
+	double a, b, u1;
+
+	a = x + rs;
+	b = y - rc;
+	if ((fabs(a)<EPS3) && (fabs(b)<EPS3)) return(INFINITY);
+	u1 = sqrt(a*a + b * b);
+	if (u1 > ctx->radcurvmul4) return(INFINITY);
+	return(ctx->radcurv * abs_angle(phi));
+}
+
+
+static double lb_c_cucu_c(const rs_context* ctx, double x, double y, double phi, double rs, double rc)
+{
+	double a, b, u1, va1;
+
+	a = x + rs;
+	b = y - rc;
+	if ((fabs(a)<EPS3) && (fabs(b)<EPS3)) return(INFINITY);
+	u1 = sqrt(a*a + b * b);
+	if (u1 > 6 * ctx->radcurv) return(INFINITY);
+	va1 = (5 * ctx->sqradcurv - u1 * u1 / 4) / ctx->sqradcurvmul2;
+	if ((va1 < 0.0) || (va1 > 1.0)) return(INFINITY);
+	return(ctx->radcurv * abs_angle(phi));
+}
+
+
+/***********************************************************/
+/*
+The 48 RS curves come in 12 families of 4 curves, computed by the same
+function for 4 symmetric increments of configuration. The curve number
+4 * f + i + 1 is the family f of rs_length_families for the increment
+rs_reflection[f >= 2][i], whose x, y and phi are multiplied by rs_sign_x,
+rs_sign_y and rs_sign_phi. rs_words gives the segments of each curve.
+*/
+typedef double (*rs_curve_fn)(const rs_context* ctx, double x, double y, double phi, double rs, double rc, double* t, double* u, double* v);
+typedef double (*rs_bound_fn)(const rs_context* ctx, double x, double y, double phi, double rs, double rc);
+
+static const struct
+{
+	rs_curve_fn curve;
+	rs_bound_fn bound;
+	int b2;		/* uses b2 instead of b1 */
+} rs_length_families[12] = {
+	{ c_c_c, lb_c_c_c, 0 },
+	{ c_cc, lb_c_cc, 0 },
+	{ csca, lb_csca, 0 },
+	{ cscb, lb_cscb, 1 },
+	{ ccu_cuc, lb_ccu_cuc, 1 },
+	{ c_cucu_c, lb_c_cucu_c, 1 },
+	{ c_c2sca, lb_c2sca, 0 },
+	{ c_c2scb, lb_c2scb, 1 },
+	{ c_c2sc2_c, lb_c2sc2_c, 1 },
+	{ cc_c, lb_c_cc, 0 },
+	{ csc2_ca, lb_csc2_ca, 0 },
+	{ csc2_cb, lb_c2scb, 1 }
+};
+
+/* signs of x, y and phi in the four symmetric increments */
+static const double rs_sign_x[4] = { 1.0, -1.0, 1.0, -1.0 };
+static const double rs_sign_y[4] = { 1.0, 1.0, -1.0, -1.0 };
+static const double rs_sign_phi[4] = { 1.0, -1.0, -1.0, 1.0 };
+
+/* increment of each curve of a family, for the families 0 to 1 and 2 to 11 */
+static const int rs_reflection[2][4] = { { 0, 1, 2, 3 }, { 0, 2, 1, 3 } };
+
+
+/***********************************************************/
+/*
+rs_solve_canonical finds the same curve as the full scan of rs_solve, for
+the contexts set to RS_SCAN_CANONICAL, without computing the 48 curves.
+
+The reflection g of rs_sign_x and rs_sign_y that brings (x,y) to x >= 0
+and y >= 0 is applied to the increment, and the family f for the
+reflected increment r is the family f for the increment r ^ g of
+(x,y,phi). With phi reduced to (-pi, pi], the shortest curve of the
+reflected increment was, for all the random increments tried, one of the
+13 curves flagged in rs_canonical[0] when its phi is positive or zero,
+and one of the 12 curves of rs_canonical[1] when it is negative, the
+index being 4 * f + r. This is not proven, and it does not hold near
+x = 0, y = 0, phi = 0 or phi = pi, and for small increments, where other
+curves are shorter by up to 2 pi radcurv. So the flagged curves are only
+computed first, to find a short curve early, and the other ones are
+computed unless their lower bound (see rs_solve_length) is above the best
+length found by more than EPS1 * (radcurv + length), a margin for the
+rounding of the bounds and of the curves that grows with the lengths.
+Since the bounds are proven, the result is the one of the full scan,
+ties included. About 10 curves pass the bounds, mostly C|CC, CC|C and
+CC|C|C whose bounds are loose, so that about 23 curve functions are
+computed instead of 48.
+*/
+static const char rs_canonical[2][48] = {
+	{ 1, 0, 0, 0, 0, 0, 0, 1, 1, 0, 0, 0, 1, 0, 1, 0, 0, 1, 0, 0, 0, 0, 0, 1,
+	  0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 1, 0, 0, 0, 1, 0, 1, 0, 0, 0 },
+	{ 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0, 0, 0, 1, 1,
+	  0, 0, 1, 0, 0, 0, 1, 0, 0, 0, 1, 1, 1, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0 }
+};
+
+static double rs_solve_canonical(const rs_context* ctx, double x, double y, double phi, int* numero, double* tr, double* ur, double* vr)
+{
+	double t, u, v, tn, un, vn;
+	double var, length, xr, yr, phir, rsr, rcr;
+	double sphi, cphi, b1, b2, p;
+	int g, h, first, c, f, r, num, n;
+
+	sphi = sin(phi);
+	cphi = cos(phi);
+
+	b1 = ctx->radcurv * (cphi - 1);
+	b2 = ctx->radcurv * (cphi + 1);
+
+	/* phi in (-pi, pi] */
+	p = mod2pi(phi);
+	if (p > MPI) p = p - MPIMUL2;
+
+	g = (x < 0) + 2 * (y < 0);
+	h = (rs_sign_phi[g] * p < 0);
+
+	length = INFINITY;
+	num = 0;
+	t = u = v = 0;
+	for (first = 1; first >= 0; first--)
+		for (c = 0; c < 48; c++)
+		{
+			if (rs_canonical[h][c] != first) continue;
+			f = c / 4;
+			r = (c % 4) ^ g;
+			xr = rs_sign_x[r] * x;
+			yr = rs_sign_y[r] * y;
+			phir = rs_sign_phi[r] * phi;
+			rsr = rs_sign_phi[r] * ctx->radcurv * sphi;
+			rcr = rs_length_families[f].b2 ? b2 : b1;
+			if (!first && (rs_length_families[f].bound(ctx, xr, yr, phir, rsr, rcr) > length + EPS1 * (ctx->radcurv + length))) continue;
+			var = rs_length_families[f].curve(ctx, xr, yr, phir, rsr, rcr, &tn, &un, &vn);
+			n = 4 * f + rs_reflection[f >= 2][r] + 1;
+			if ((num == 0) || (var < length) || ((var == length) && (n < num)))
+			{
+				length = var;
+				num = n;
+				t = tn; u = un; v = vn;
+			}
+		}
+
+	*tr = t; *ur = u; *vr = v;
+	*numero = num;
+	return(length);
+}
+
+
+/***********************************************************/
+/*
+rs_solve scans the 48 RS curves for the increment (x,y,phi) already
+expressed in the frame of the initial configuration, in the order of
+their numbers, and keeps the first of the shortest ones. It is shared by
+reed_shepp and reed_shepp_batch.
+*/
+static double rs_solve(const rs_context* ctx, double x, double y, double phi, int* numero, double* tr, double* ur, double* vr)
+{
+	double t, u, v, tn, un, vn;
+	double var, length;
+	double sphi, cphi, b1, b2;
+	int f, i, r, num;
+
+	if (ctx->scan == RS_SCAN_CANONICAL) return(rs_solve_canonical(ctx, x, y, phi, numero, tr, ur, vr));
+
+	sphi = sin(phi);
+	cphi = cos(phi);
+
+	b1 = ctx->radcurv * (cphi - 1);
+	b2 = ctx->radcurv * (cphi + 1);
+
+	length = INFINITY;
+	num = 0;
+	t = u = v = 0;
+	for (f = 0; f < 12; f++)
+		for (i = 0; i < 4; i++)
+		{
+			r = rs_reflection[f >= 2][i];
+			var = rs_length_families[f].curve(ctx, rs_sign_x[r] * x, rs_sign_y[r] * y, rs_sign_phi[r] * phi,
+				rs_sign_phi[r] * ctx->radcurv * sphi, rs_length_families[f].b2 ? b2 : b1, &tn, &un, &vn);
+			if ((num == 0) || (var < length))
+			{
+				length = var;
+				num = 4 * f + i + 1;
+				t = tn; u = un; v = vn;
+			}
+		}
+
+	*tr = t; *ur = u; *vr = v;
+	*numero = num;
+	return(length);
+}
+
+
+/***********************************************************/
+static void rs_solve_scalar(const rs_context* ctx, int n, const double* x, const double* y, const double* phi,
+	double* length, int* numero, double* tr, double* ur, double* vr)
+{
+	int i;
+
+	for (i = 0; i < n; i++)
+		length[i] = rs_solve(ctx, x[i], y[i], phi[i], numero + i, tr + i, ur + i, vr + i);
+}
+
+
+/***********************************************************/
+/*
+Without SIMD, the single precision scan is the double one.
+*/
+#define RS_F_BLOCK 64
+
+static void rs_solve_f_scalar(const rs_context* ctx, int n, const float* x, const float* y, const float* phi,
+	float* length, int* numero, float* tr, float* ur, float* vr)
+{
+	int i;
+	double l, t, u, v;
+
+	for (i = 0; i < n; i++)
+	{
+		l = rs_solve(ctx, x[i], y[i], phi[i], numero + i, &t, &u, &v);
+		length[i] = (float)l;
+		tr[i] = (float)t;
+		ur[i] = (float)u;
+		vr[i] = (float)v;
+	}
+}
+
+
+/***********************************************************/
+/*
+The vectorized single precision scans lose much of the precision on the
+curves shorter than the radius, where the lengths of the other curves
+can be wrong by much more than the difference between them: the curve
+picked was then up to 50 % longer than the shortest one. rs_solve_f_short
+solves these queries again with rs_solve_f_scalar.
+*/
+static void rs_solve_f_short(const rs_context* ctx, int n, const float* x, const float* y, const float* phi,
+	float* length, int* numero, float* tr, float* ur, float* vr)
+{
+	int i;
+
+	for (i = 0; i < n; i++)
+		if (length[i] < ctx->radcurv)
+			rs_solve_f_scalar(ctx, 1, x + i, y + i, phi + i, length + i, numero + i, tr + i, ur + i, vr + i);
+}
+
+
+/***********************************************************/
+/*
+rs_solve_word computes the curve number num only, for the increment
+(x,y,phi). Returns INFINITY when it does not exist.
+*/
+static double rs_solve_word(const rs_context* ctx, double x, double y, double phi, int num, double* t, double* u, double* v)
+{
+	double sphi, cphi;
+	int f, r;
+
+	f = (num - 1) / 4;
+	r = rs_reflection[f >= 2][(num - 1) % 4];
+	sphi = sin(phi);
+	cphi = cos(phi);
+
+	return(rs_length_families[f].curve(ctx, rs_sign_x[r] * x, rs_sign_y[r] * y, rs_sign_phi[r] * phi,
+		rs_sign_phi[r] * ctx->radcurv * sphi, ctx->radcurv * (rs_length_families[f].b2 ? cphi + 1 : cphi - 1), t, u, v));
+}
+
+
+/***********************************************************/
+EXPORT
+float reed_shepp_f_ctx(const rs_context* ctx, float x1, float y1, float t1, float x2, float y2, float t2, int* numero, float* tr, float* ur, float* vr)
+{
+	float x, y, phi, dx, dy, ct, st, length;
+	rs_solve_f_fn solve;
+
+	/* coordinate change */
+	dx = x2 - x1;
+	dy = y2 - y1;
+	ct = cosf(t1);
+	st = sinf(t1);
+	x = dx * ct + dy * st;
+	y = dy * ct - dx * st;
+	phi = t2 - t1;
+
+	solve = (ctx->scan == RS_SCAN_CANONICAL) ? rs_solve_f_scalar : rs_solve_f_one;
+	solve(ctx, 1, &x, &y, &phi, &length, numero, tr, ur, vr);
+	if (solve != rs_solve_f_scalar) rs_solve_f_short(ctx, 1, &x, &y, &phi, &length, numero, tr, ur, vr);
+	return(length);
+}
+
+
+/***********************************************************/
+EXPORT
+float reed_shepp_f(float x1, float y1, float t1, float x2, float y2, float t2, int* numero, float* tr, float* ur, float* vr)
+{
+	return(reed_shepp_f_ctx(&rs_default, x1, y1, t1, x2, y2, t2, numero, tr, ur, vr));
+}
+
+
+/***********************************************************/
+EXPORT
+void reed_shepp_batch_f_ctx(const rs_context* ctx, int n, const float* x1, const float* y1, const float* t1, const float* x2, const float* y2, const float* t2,
+	float* length, int* numero, float* tr, float* ur, float* vr)
+{
+	float x[RS_F_BLOCK], y[RS_F_BLOCK], phi[RS_F_BLOCK];
+	float dx, dy, ct, st;
+	rs_solve_f_fn solve;
+	int i, j, m;
+
+	solve = (ctx->scan == RS_SCAN_CANONICAL) ? rs_solve_f_scalar : rs_solve_f_many;
+	for (i = 0; i < n; i += RS_F_BLOCK)
+	{
+		m = (n - i < RS_F_BLOCK) ? n - i : RS_F_BLOCK;
+
+		/* coordinate change */
+		for (j = 0; j < m; j++)
+		{
+			dx = x2[i + j] - x1[i + j];
+			dy = y2[i + j] - y1[i + j];
+			ct = cosf(t1[i + j]);
+			st = sinf(t1[i + j]);
+			x[j] = dx * ct + dy * st;
+			y[j] = dy * ct - dx * st;
+			phi[j] = t2[i + j] - t1[i + j];
+		}
+
+		solve(ctx, m, x, y, phi, length + i, numero + i, tr + i, ur + i, vr + i);
+		if (solve != rs_solve_f_scalar) rs_solve_f_short(ctx, m, x, y, phi, length + i, numero + i, tr + i, ur + i, vr + i);
+	}
+}
+
+
+/***********************************************************/
+EXPORT
+void reed_shepp_batch_f(int n, const float* x1, const float* y1, const float* t1, const float* x2, const float* y2, const float* t2,
+	float* length, int* numero, float* tr, float* ur, float* vr)
+{
+	reed_shepp_batch_f_ctx(&rs_default, n, x1, y1, t1, x2, y2, t2, length, numero, tr, ur, vr);
+}
+
+
+/***********************************************************/
+/*
+rs_solve_mixed does the coordinate change in double, picks the curve of
+each query with the single precision scan, then computes this curve only
+in double. When its length in double is not the one found in single
+precision, up to RS_MIXED_TOLERANCE * (radcurv + length), the query is
+solved again in double: the curve then does not exist in double, or one
+of its arcs is close to 0 in one precision and to 2 pi in the other.
+Curves shorter than the radius are solved again in double too: near the
+start, the single precision lengths of the other curves can be wrong by
+much more than the difference between them, and the curve picked was up
+to 50 % longer than the shortest one.
+*/
+#define RS_MIXED_TOLERANCE 1.0e-3
+
+static void rs_solve_mixed(const rs_context* ctx, rs_solve_f_fn solve_f, int n, const double* x1, const double* y1, const double* t1,
+	const double* x2, const double* y2, const double* t2, double* length, int* numero, double* tr, double* ur, double* vr)
+{
+	double x[RS_F_BLOCK], y[RS_F_BLOCK], phi[RS_F_BLOCK];
+	float xf[RS_F_BLOCK], yf[RS_F_BLOCK], phif[RS_F_BLOCK];
+	float lf[RS_F_BLOCK], tf[RS_F_BLOCK], uf[RS_F_BLOCK], vf[RS_F_BLOCK];
+	double dx, dy, ct, st;
+	int i, j, m;
+
+	for (i = 0; i < n; i += RS_F_BLOCK)
+	{
+		m = (n - i < RS_F_BLOCK) ? n - i : RS_F_BLOCK;
+
+		/* coordinate change */
+		for (j = 0; j < m; j++)
+		{
+			dx = x2[i + j] - x1[i + j];
+			dy = y2[i + j] - y1[i + j];
+			ct = cos(t1[i + j]);
+			st = sin(t1[i + j]);
+			x[j] = dx * ct + dy * st;
+			y[j] = dy * ct - dx * st;
+			phi[j] = t2[i + j] - t1[i + j];
+			xf[j] = (float)x[j];
+			yf[j] = (float)y[j];
+			phif[j] = (float)phi[j];
+		}
+
+		solve_f(ctx, m, xf, yf, phif, lf, numero + i, tf, uf, vf);
+
+		for (j = 0; j < m; j++)
+		{
+			length[i + j] = rs_solve_word(ctx, x[j], y[j], phi[j], numero[i + j], tr + i + j, ur + i + j, vr + i + j);
+			if ((lf[j] < ctx->radcurv) || (fabs(length[i + j] - lf[j]) > RS_MIXED_TOLERANCE * (ctx->radcurv + lf[j])))
+				length[i + j] = rs_solve(ctx, x[j], y[j], phi[j], numero + i + j, tr + i + j, ur + i + j, vr + i + j);
+		}
+	}
+}
+
+
+/***********************************************************/
+EXPORT
+void reed_shepp_batch_mixed_ctx(const rs_context* ctx, int n, const double* x1, const double* y1, const double* t1, const double* x2, const double* y2, const double* t2,
+	double* length, int* numero, double* tr, double* ur, double* vr)
+{
+	rs_solve_mixed(ctx, (ctx->scan == RS_SCAN_CANONICAL) ? rs_solve_f_scalar : rs_solve_f_many, n, x1, y1, t1, x2, y2, t2, length, numero, tr, ur, vr);
+}
+
+
+/***********************************************************/
+EXPORT
+void reed_shepp_batch_mixed(int n, const double* x1, const double* y1, const double* t1, const double* x2, const double* y2, const double* t2,
+	double* length, int* numero, double* tr, double* ur, double* vr)
+{
+	reed_shepp_batch_mixed_ctx(&rs_default, n, x1, y1, t1, x2, y2, t2, length, numero, tr, ur, vr);
+}
+
+
+/***********************************************************/
+EXPORT
+double reed_shepp_mixed_ctx(const rs_context* ctx, double x1, double y1, double t1, double x2, double y2, double t2, int* numero, double* tr, double* ur, double* vr)
+{
+	double length;
+
+	rs_solve_mixed(ctx, (ctx->scan == RS_SCAN_CANONICAL) ? rs_solve_f_scalar : rs_solve_f_one, 1, &x1, &y1, &t1, &x2, &y2, &t2, &length, numero, tr, ur, vr);
+	return(length);
+}
+
+
+/***********************************************************/
+EXPORT
+double reed_shepp_mixed(double x1, double y1, double t1, double x2, double y2, double t2, int* numero, double* tr, double* ur, double* vr)
+{
+	return(reed_shepp_mixed_ctx(&rs_default, x1, y1, t1, x2, y2, t2, numero, tr, ur, vr));
+}
+
+
+/***********************************************************/
+/*
+rs_solve_length computes only the length of the shortest RS curve. It
+first computes the lower bounds of the 48 curves, then computes the
+curves by increasing lower bound and stops at the first bound that is
+not below the best length found so far.
+*/
+static double rs_solve_length(const rs_context* ctx, double x, double y, double phi)
+{
+	double bound[48];
+	int curve[48];
+	double t, u, v, var, length, lb, xr, yr, phir, rsr, rcr;
+	double sphi, cphi, b1, b2;
+	int f, r, i, j, n, c;
+
+	sphi = sin(phi);
+	cphi = cos(phi);
+
+	b1 = ctx->radcurv * (cphi - 1);
+	b2 = ctx->radcurv * (cphi + 1);
+
+	/* lower bounds, sorted by insertion */
+	n = 0;
+	for (f = 0; f < 12; f++)
+		for (r = 0; r < 4; r++)
+		{
+			lb = rs_length_families[f].bound(ctx, rs_sign_x[r] * x, rs_sign_y[r] * y, rs_sign_phi[r] * phi,
+				rs_sign_phi[r] * ctx->radcurv * sphi, rs_length_families[f].b2 ? b2 : b1);
+			if (lb >= INFINITY) continue;
+			for (j = n; (j > 0) && (bound[j - 1] > lb); j--)
+			{
+				bound[j] = bound[j - 1];
+				curve[j] = curve[j - 1];
+			}
+			bound[j] = lb;
+			curve[j] = 4 * f + r;
+			n++;
+		}
+
+	length = INFINITY;
+	for (i = 0; (i < n) && (bound[i] < length); i++)
+	{
+		c = curve[i];
+		f = c / 4;
+		r = c % 4;
+		xr = rs_sign_x[r] * x;
+		yr = rs_sign_y[r] * y;
+		phir = rs_sign_phi[r] * phi;
+		rsr = rs_sign_phi[r] * ctx->radcurv * sphi;
+		rcr = rs_length_families[f].b2 ? b2 : b1;
+		var = rs_length_families[f].curve(ctx, xr, yr, phir, rsr, rcr, &t, &u, &v);
+		if (var < length) length = var;
+	}
+
+	return(length);
+}
+
+
+/***********************************************************/
+/*
+Counts, for rs_stats, the curves of each family that do not exist for one
+of the n increments (x[i],y[i],phi[i]) in every RS_STATS_SAMPLING, and
+records them with the curves chosen and the time taken by the scan.
+rs_stats_tick numbers the increments of the thread, so that the ones
+sampled are spread over the calls of one increment.
+*/
+#define RS_STATS_SAMPLING 64
+
+static __thread unsigned int rs_stats_tick = 0;
+
+static void rs_stats_solve(const rs_context* ctx, int n, const double* x, const double* y, const double* phi,
+	const int* numero, unsigned long long cycles)
+{
+	unsigned int rejections[12];
+	double t, u, v, sphi, cphi, b1, b2;
+	int i, f, r, sampled;
+
+	memset(rejections, 0, sizeof(rejections));
+	sampled = 0;
+	for (i = 0; i < n; i++)
+	{
+		if ((rs_stats_tick++ % RS_STATS_SAMPLING) != 0) continue;
+		sampled++;
+		sphi = sin(phi[i]);
+		cphi = cos(phi[i]);
+		b1 = ctx->radcurv * (cphi - 1);
+		b2 = ctx->radcurv * (cphi + 1);
+		for (f = 0; f < 12; f++)
+			for (r = 0; r < 4; r++)
+				if (rs_length_families[f].curve(ctx, rs_sign_x[r] * x[i], rs_sign_y[r] * y[i], rs_sign_phi[r] * phi[i],
+					rs_sign_phi[r] * ctx->radcurv * sphi, rs_length_families[f].b2 ? b2 : b1, &t, &u, &v) >= INFINITY)
+					rejections[f]++;
+	}
+
+	rs_stats_add_solve(n, numero, sampled, rejections, cycles);
+}
+
+
+/***********************************************************/
+EXPORT
+double reed_shepp_length_ctx(const rs_context* ctx, double x1, double y1, double t1, double x2, double y2, double t2)
+{
+	double dx, dy, ct, st;
+
+	/* coordinate change */
+	dx = x2 - x1;
+	dy = y2 - y1;
+	ct = cos(t1);
+	st = sin(t1);
+
+	return(rs_solve_length(ctx, dx * ct + dy * st, dy * ct - dx * st, t2 - t1));
+}
+
+
+/***********************************************************/
+EXPORT
+double reed_shepp_length(double x1, double y1, double t1, double x2, double y2, double t2)
+{
+	return(reed_shepp_length_ctx(&rs_default, x1, y1, t1, x2, y2, t2));
+}
+
+
+/***********************************************************/
+/*
+rs_solve_topk keeps the k shortest of the RS curves in mask (among the
+ones that exist), sorted by length, and ties by number as in rs_solve. A
+curve is only computed when it is in mask and its lower bound is below
+the k-th length kept.
+*/
+static int rs_solve_topk(const rs_context* ctx, double x, double y, double phi, unsigned long long mask, int k,
+	double* length, int* numero, double* tr, double* ur, double* vr)
+{
+	double t, u, v, var, xr, yr, phir, rsr, rcr;
+	double sphi, cphi, b1, b2;
+	int f, i, j, r, n;
+
+	if (k > 48) k = 48;
+	if (k <= 0) return(0);
+
+	sphi = sin(phi);
+	cphi = cos(phi);
+
+	b1 = ctx->radcurv * (cphi - 1);
+	b2 = ctx->radcurv * (cphi + 1);
+
+	n = 0;
+	for (f = 0; f < 12; f++)
+		for (i = 0; i < 4; i++)
+		{
+			if (!(mask & RS_MASK_WORD(4 * f + i + 1))) continue;
+
+			r = rs_reflection[f >= 2][i];
+			xr = rs_sign_x[r] * x;
+			yr = rs_sign_y[r] * y;
+			phir = rs_sign_phi[r] * phi;
+			rsr = rs_sign_phi[r] * ctx->radcurv * sphi;
+			rcr = rs_length_families[f].b2 ? b2 : b1;
+
+			/* EPS1: the bound may round above a length equal to it */
+			if ((n == k) && (rs_length_families[f].bound(ctx, xr, yr, phir, rsr, rcr) >= length[k - 1] + EPS1)) continue;
+			var = rs_length_families[f].curve(ctx, xr, yr, phir, rsr, rcr, &t, &u, &v);
+			if (var >= INFINITY) continue;
+			if ((n == k) && (var >= length[k - 1])) continue;
+
+			/* insertion in the sorted list */
+			if (n < k) n++;
+			for (j = n - 1; (j > 0) && (length[j - 1] > var); j--)
+			{
+				length[j] = length[j - 1];
+				numero[j] = numero[j - 1];
+				tr[j] = tr[j - 1];
+				ur[j] = ur[j - 1];
+				vr[j] = vr[j - 1];
+			}
+			length[j] = var;
+			numero[j] = 4 * f + i + 1;
+			tr[j] = t;
+			ur[j] = u;
+			vr[j] = v;
+		}
+
+	return(n);
+}
+
+
+/***********************************************************/
+EXPORT
+int reed_shepp_topk_ctx(const rs_context* ctx, double x1, double y1, double t1, double x2, double y2, double t2, int k,
+	double* length, int* numero, double* tr, double* ur, double* vr)
+{
+	double dx, dy, ct, st;
+
+	/* coordinate change */
+	dx = x2 - x1;
+	dy = y2 - y1;
+	ct = cos(t1);
+	st = sin(t1);
+
+	return(rs_solve_topk(ctx, dx * ct + dy * st, dy * ct - dx * st, t2 - t1, RS_MASK_ALL, k, length, numero, tr, ur, vr));
+}
+
+
+/***********************************************************/
+EXPORT
+int reed_shepp_topk(double x1, double y1, double t1, double x2, double y2, double t2, int k,
+	double* length, int* numero, double* tr, double* ur, double* vr)
+{
+	return(reed_shepp_topk_ctx(&rs_default, x1, y1, t1, x2, y2, t2, k, length, numero, tr, ur, vr));
+}
+
+
+/***********************************************************/
+EXPORT
+double reed_shepp_filtered_ctx(const rs_context* ctx, double x1, double y1, double t1, double x2, double y2, double t2, unsigned long long mask,
+	int* numero, double* tr, double* ur, double* vr)
+{
+	double dx, dy, ct, st, length;
+
+	/* coordinate change */
+	dx = x2 - x1;
+	dy = y2 - y1;
+	ct = cos(t1);
+	st = sin(t1);
+
+	if (rs_solve_topk(ctx, dx * ct + dy * st, dy * ct - dx * st, t2 - t1, mask, 1, &length, numero, tr, ur, vr) == 0)
+	{
+		*numero = 0;
+		return(-1);
+	}
+	return(length);
+}
+
+
+/***********************************************************/
+EXPORT
+double reed_shepp_filtered(double x1, double y1, double t1, double x2, double y2, double t2, unsigned long long mask,
+	int* numero, double* tr, double* ur, double* vr)
+{
+	return(reed_shepp_filtered_ctx(&rs_default, x1, y1, t1, x2, y2, t2, mask, numero, tr, ur, vr));
+}
+
+
+/***********************************************************/
+/*
+rs_word_cost is the cost of the curve number num, parameters t, u and v:
+the sum over its segments of their lengths times the weight of their
+kind, plus cost->cusp for each change of direction. Segments of length 0
+count for nothing, and do not make a cusp.
+*/
+static double rs_word_cost(const rs_context* ctx, const rs_cost* cost, int num, double t, double u, double v)
+{
+	const rs_segment* seg;
+	double lengths[4], l, c;
+	int i, last;
+
+	lengths[RS_T] = t;
+	lengths[RS_U] = u;
+	lengths[RS_V] = v;
+	lengths[RS_HALFPI] = MPIDIV2;
+
+	c = 0;
+	last = 0;
+	for (i = 0; (i < RS_MAX_SEGMENTS) && (rs_words[num - 1][i].type != 0); i++)
+	{
+		seg = &rs_words[num - 1][i];
+		l = lengths[seg->length];
+		if (seg->type != RS_STRAIGHT) l = l * ctx->radcurv;
+		if (l < EPS4 * ctx->radcurv) continue;
+
+		if (seg->type == RS_STRAIGHT) c = c + l * ((seg->orientation == 1) ? cost->forward_straight : cost->reverse_straight);
+		else c = c + l * ((seg->orientation == 1) ? cost->forward_arc : cost->reverse_arc);
+		if ((last != 0) && (seg->orientation != last)) c = c + cost->cusp;
+		last = seg->orientation;
+	}
+
+	return(c);
+}
+
+
+/***********************************************************/
+/*
+rs_solve_weighted scans the 48 RS curves like rs_solve_topk, keeping the
+one of smallest cost. The smallest weight times the lower bound of the
+length of a curve is a lower bound of its cost.
+*/
+static double rs_solve_weighted(const rs_context* ctx, double x, double y, double phi, const rs_cost* cost,
+	int* numero, double* tr, double* ur, double* vr)
+{
+	double t, u, v, var, best, wmin, xr, yr, phir, rsr, rcr;
+	double sphi, cphi, b1, b2;
+	int f, i, r, num;
+
+	wmin = cost->forward_arc;
+	if (cost->reverse_arc < wmin) wmin = cost->reverse_arc;
+	if (cost->forward_straight < wmin) wmin = cost->forward_straight;
+	if (cost->reverse_straight < wmin) wmin = cost->reverse_straight;
+	if (wmin < 0) wmin = 0;
+
+	sphi = sin(phi);
+	cphi = cos(phi);
+
+	b1 = ctx->radcurv * (cphi - 1);
+	b2 = ctx->radcurv * (cphi + 1);
+
+	best = HUGE_VAL;
+	*numero = 0;
+	for (f = 0; f < 12; f++)
+		for (i = 0; i < 4; i++)
+		{
+			r = rs_reflection[f >= 2][i];
+			num = 4 * f + i + 1;
+			xr = rs_sign_x[r] * x;
+			yr = rs_sign_y[r] * y;
+			phir = rs_sign_phi[r] * phi;
+			rsr = rs_sign_phi[r] * ctx->radcurv * sphi;
+			rcr = rs_length_families[f].b2 ? b2 : b1;
+
+			if (wmin * rs_length_families[f].bound(ctx, xr, yr, phir, rsr, rcr) >= best + EPS1) continue;
+			if (rs_length_families[f].curve(ctx, xr, yr, phir, rsr, rcr, &t, &u, &v) >= INFINITY) continue;
+
+			var = rs_word_cost(ctx, cost, num, t, u, v);
+			if (var < best)
+			{
+				best = var;
+				*numero = num;
+				*tr = t;
+				*ur = u;
+				*vr = v;
+			}
+		}
+
+	return(best);
+}
+
+
+/***********************************************************/
+EXPORT
+double reed_shepp_weighted_ctx(const rs_context* ctx, double x1, double y1, double t1, double x2, double y2, double t2, const rs_cost* cost,
+	int* numero, double* tr, double* ur, double* vr)
+{
+	double dx, dy, ct, st;
+
+	/* coordinate change */
+	dx = x2 - x1;
+	dy = y2 - y1;
+	ct = cos(t1);
+	st = sin(t1);
+
+	return(rs_solve_weighted(ctx, dx * ct + dy * st, dy * ct - dx * st, t2 - t1, cost, numero, tr, ur, vr));
+}
+
+
+/***********************************************************/
+EXPORT
+double reed_shepp_weighted(double x1, double y1, double t1, double x2, double y2, double t2, const rs_cost* cost,
+	int* numero, double* tr, double* ur, double* vr)
+{
+	return(reed_shepp_weighted_ctx(&rs_default, x1, y1, t1, x2, y2, t2, cost, numero, tr, ur, vr));
+}
+
+
+/***********************************************************/
+/*
+The masks below are computed from the segments of the curves in rs_words.
+A cusp is a change of direction between two segments.
+*/
+EXPORT
+unsigned long long rs_mask_max_cusps(int cusps)
+{
+	unsigned long long mask;
+	int num, i, n;
+
+	mask = 0;
+	for (num = 1; num <= 48; num++)
+	{
+		n = 0;
+		for (i = 1; (i < RS_MAX_SEGMENTS) && (rs_words[num - 1][i].type != 0); i++)
+			if (rs_words[num - 1][i].orientation != rs_words[num - 1][i - 1].orientation) n++;
+		if (n <= cusps) mask |= RS_MASK_WORD(num);
+	}
+	return(mask);
+}
+
+
+/***********************************************************/
+EXPORT
+unsigned long long rs_mask_no_reverse(void)
+{
+	unsigned long long mask;
+	int num, i, ok;
+
+	mask = 0;
+	for (num = 1; num <= 48; num++)
+	{
+		ok = 1;
+		for (i = 0; (i < RS_MAX_SEGMENTS) && (rs_words[num - 1][i].type != 0); i++)
+			if (rs_words[num - 1][i].orientation != 1) ok = 0;
+		if (ok) mask |= RS_MASK_WORD(num);
+	}
+	return(mask);
+}
+
+
+/***********************************************************/
+EXPORT
+unsigned long long rs_mask_csc(void)
+{
+	unsigned long long mask;
+	const rs_segment* w;
+	int num;
+
+	mask = 0;
+	for (num = 1; num <= 48; num++)
+	{
+		w = rs_words[num - 1];
+		if ((w[0].type != RS_STRAIGHT) && (w[1].type == RS_STRAIGHT) && (w[2].type != RS_STRAIGHT) && (w[2].type != 0)
+			&& (w[3].type == 0))
+			mask |= RS_MASK_WORD(num);
+	}
+	return(mask);
+}
+
+
+/***********************************************************/
+EXPORT
+double min_length_rs_ctx(const rs_context* ctx, double x1, double y1, double t1, double x2, double y2, double t2, int* numero, double* t, double* u, double* v)
+{
+	double length_rs;
+
+	if ((fabs(x1 - x2)<EPS1) && (fabs(y1 - y2)<EPS1)
+		&& (fabs(t1 - t2)<EPS1))  length_rs = 0.0;
+	else length_rs = reed_shepp_ctx(ctx, x1, y1, t1, x2, y2, t2, numero, t, u, v);
+
+	return(length_rs);
+}
+
+
+/***********************************************************/
+EXPORT
+double min_length_rs(double x1, double y1, double t1, double x2, double y2, double t2, int* numero, double* t, double* u, double* v)
+{
+	return(min_length_rs_ctx(&rs_default, x1, y1, t1, x2, y2, t2, numero, t, u, v));
+}
+
+
+/***********************************************************/
+const rs_segment rs_words[48][RS_MAX_SEGMENTS] = {
+	{ { RS_LEFT, 1, RS_T }, { RS_RIGHT, -1, RS_U }, { RS_LEFT, 1, RS_V } },	/* 1 */
+	{ { RS_LEFT, -1, RS_T }, { RS_RIGHT, 1, RS_U }, { RS_LEFT, -1, RS_V } },	/* 2 */
+	{ { RS_RIGHT, 1, RS_T }, { RS_LEFT, -1, RS_U }, { RS_RIGHT, 1, RS_V } },	/* 3 */
+	{ { RS_RIGHT, -1, RS_T }, { RS_LEFT, 1, RS_U }, { RS_RIGHT, -1, RS_V } },	/* 4 */
+	{ { RS_LEFT, 1, RS_T }, { RS_RIGHT, -1, RS_U }, { RS_LEFT, -1, RS_V } },	/* 5 */
+	{ { RS_LEFT, -1, RS_T }, { RS_RIGHT, 1, RS_U }, { RS_LEFT, 1, RS_V } },	/* 6 */
+	{ { RS_RIGHT, 1, RS_T }, { RS_LEFT, -1, RS_U }, { RS_RIGHT, -1, RS_V } },	/* 7 */
+	{ { RS_RIGHT, -1, RS_T }, { RS_LEFT, 1, RS_U }, { RS_RIGHT, 1, RS_V } },	/* 8 */
+	{ { RS_LEFT, 1, RS_T }, { RS_STRAIGHT, 1, RS_U }, { RS_LEFT, 1, RS_V } },	/* 9 */
+	{ { RS_RIGHT, 1, RS_T }, { RS_STRAIGHT, 1, RS_U }, { RS_RIGHT, 1, RS_V } },	/* 10 */
+	{ { RS_LEFT, -1, RS_T }, { RS_STRAIGHT, -1, RS_U }, { RS_LEFT, -1, RS_V } },	/* 11 */
+	{ { RS_RIGHT, -1, RS_T }, { RS_STRAIGHT, -1, RS_U }, { RS_RIGHT, -1, RS_V } },	/* 12 */
+	{ { RS_LEFT, 1, RS_T }, { RS_STRAIGHT, 1, RS_U }, { RS_RIGHT, 1, RS_V } },	/* 13 */
+	{ { RS_RIGHT, 1, RS_T }, { RS_STRAIGHT, 1, RS_U }, { RS_LEFT, 1, RS_V } },	/* 14 */
+	{ { RS_LEFT, -1, RS_T }, { RS_STRAIGHT, -1, RS_U }, { RS_RIGHT, -1, RS_V } },	/* 15 */
+	{ { RS_RIGHT, -1, RS_T }, { RS_STRAIGHT, -1, RS_U }, { RS_LEFT, -1, RS_V } },	/* 16 */
+	{ { RS_LEFT, 1, RS_T }, { RS_RIGHT, 1, RS_U }, { RS_LEFT, -1, RS_U }, { RS_RIGHT, -1, RS_V } },	/* 17 */
+	{ { RS_RIGHT, 1, RS_T }, { RS_LEFT, 1, RS_U }, { RS_RIGHT, -1, RS_U }, { RS_LEFT, -1, RS_V } },	/* 18 */
+	{ { RS_LEFT, -1, RS_T }, { RS_RIGHT, -1, RS_U }, { RS_LEFT, 1, RS_U }, { RS_RIGHT, 1, RS_V } },	/* 19 */
+	{ { RS_RIGHT, -1, RS_T }, { RS_LEFT, -1, RS_U }, { RS_RIGHT, 1, RS_U }, { RS_LEFT, 1, RS_V } },	/* 20 */
+	{ { RS_LEFT, 1, RS_T }, { RS_RIGHT, -1, RS_U }, { RS_LEFT, -1, RS_U }, { RS_RIGHT, 1, RS_V } },	/* 21 */
+	{ { RS_RIGHT, 1, RS_T }, { RS_LEFT, -1, RS_U }, { RS_RIGHT, -1, RS_U }, { RS_LEFT, 1, RS_V } },	/* 22 */
+	{ { RS_LEFT, -1, RS_T }, { RS_RIGHT, 1, RS_U }, { RS_LEFT, 1, RS_U }, { RS_RIGHT, -1, RS_V } },	/* 23 */
+	{ { RS_RIGHT, -1, RS_T }, { RS_LEFT, 1, RS_U }, { RS_RIGHT, 1, RS_U }, { RS_LEFT, -1, RS_V } },	/* 24 */
+	{ { RS_LEFT, 1, RS_T }, { RS_RIGHT, -1, RS_HALFPI }, { RS_STRAIGHT, -1, RS_U }, { RS_LEFT, -1, RS_V } },	/* 25 */
+	{ { RS_RIGHT, 1, RS_T }, { RS_LEFT, -1, RS_HALFPI }, { RS_STRAIGHT, -1, RS_U }, { RS_RIGHT, -1, RS_V } },	/* 26 */
+	{ { RS_LEFT, -1, RS_T }, { RS_RIGHT, 1, RS_HALFPI }, { RS_STRAIGHT, 1, RS_U }, { RS_LEFT, 1, RS_V } },	/* 27 */
+	{ { RS_RIGHT, -1, RS_T }, { RS_LEFT, 1, RS_HALFPI }, { RS_STRAIGHT, 1, RS_U }, { RS_RIGHT, 1, RS_V } },	/* 28 */
+	{ { RS_LEFT, 1, RS_T }, { RS_RIGHT, -1, RS_HALFPI }, { RS_STRAIGHT, -1, RS_U }, { RS_RIGHT, -1, RS_V } },	/* 29 */
+	{ { RS_RIGHT, 1, RS_T }, { RS_LEFT, -1, RS_HALFPI }, { RS_STRAIGHT, -1, RS_U }, { RS_LEFT, -1, RS_V } },	/* 30 */
+	{ { RS_LEFT, -1, RS_T }, { RS_RIGHT, 1, RS_HALFPI }, { RS_STRAIGHT, 1, RS_U }, { RS_RIGHT, 1, RS_V } },	/* 31 */
+	{ { RS_RIGHT, -1, RS_T }, { RS_LEFT, 1, RS_HALFPI }, { RS_STRAIGHT, 1, RS_U }, { RS_LEFT, 1, RS_V } },	/* 32 */
+	{ { RS_LEFT, 1, RS_T }, { RS_RIGHT, -1, RS_HALFPI }, { RS_STRAIGHT, -1, RS_U }, { RS_LEFT, -1, RS_HALFPI }, { RS_RIGHT, 1, RS_V } },	/* 33 */
+	{ { RS_RIGHT, 1, RS_T }, { RS_LEFT, -1, RS_HALFPI }, { RS_STRAIGHT, -1, RS_U }, { RS_RIGHT, -1, RS_HALFPI }, { RS_LEFT, 1, RS_V } },	/* 34 */
+	{ { RS_LEFT, -1, RS_T }, { RS_RIGHT, 1, RS_HALFPI }, { RS_STRAIGHT, 1, RS_U }, { RS_LEFT, 1, RS_HALFPI }, { RS_RIGHT, -1, RS_V } },	/* 35 */
+	{ { RS_RIGHT, -1, RS_T }, { RS_LEFT, 1, RS_HALFPI }, { RS_STRAIGHT, 1, RS_U }, { RS_RIGHT, 1, RS_HALFPI }, { RS_LEFT, -1, RS_V } },	/* 36 */
+	{ { RS_LEFT, 1, RS_T }, { RS_RIGHT, 1, RS_U }, { RS_LEFT, -1, RS_V } },	/* 37 */
+	{ { RS_RIGHT, 1, RS_T }, { RS_LEFT, 1, RS_U }, { RS_RIGHT, -1, RS_V } },	/* 38 */
+	{ { RS_LEFT, -1, RS_T }, { RS_RIGHT, -1, RS_U }, { RS_LEFT, 1, RS_V } },	/* 39 */
+	{ { RS_RIGHT, -1, RS_T }, { RS_LEFT, -1, RS_U }, { RS_RIGHT, 1, RS_V } },	/* 40 */
+	{ { RS_LEFT, 1, RS_T }, { RS_STRAIGHT, 1, RS_U }, { RS_RIGHT, 1, RS_HALFPI }, { RS_LEFT, -1, RS_V } },	/* 41 */
+	{ { RS_RIGHT, 1, RS_T }, { RS_STRAIGHT, 1, RS_U }, { RS_LEFT, 1, RS_HALFPI }, { RS_RIGHT, -1, RS_V } },	/* 42 */
+	{ { RS_LEFT, -1, RS_T }, { RS_STRAIGHT, -1, RS_U }, { RS_RIGHT, -1, RS_HALFPI }, { RS_LEFT, 1, RS_V } },	/* 43 */
+	{ { RS_RIGHT, -1, RS_T }, { RS_STRAIGHT, -1, RS_U }, { RS_LEFT, -1, RS_HALFPI }, { RS_RIGHT, 1, RS_V } },	/* 44 */
+	{ { RS_LEFT, 1, RS_T }, { RS_STRAIGHT, 1, RS_U }, { RS_LEFT, 1, RS_HALFPI }, { RS_RIGHT, -1, RS_V } },	/* 45 */
+	{ { RS_RIGHT, 1, RS_T }, { RS_STRAIGHT, 1, RS_U }, { RS_RIGHT, 1, RS_HALFPI }, { RS_LEFT, -1, RS_V } },	/* 46 */
+	{ { RS_LEFT, -1, RS_T }, { RS_STRAIGHT, -1, RS_U }, { RS_LEFT, -1, RS_HALFPI }, { RS_RIGHT, 1, RS_V } },	/* 47 */
+	{ { RS_RIGHT, -1, RS_T }, { RS_STRAIGHT, -1, RS_U }, { RS_RIGHT, -1, RS_HALFPI }, { RS_LEFT, 1, RS_V } },	/* 48 */
+};
+
+
+/***********************************************************/
+int fct_curve(const rs_context* ctx, int ty, int orientation, double val, double* x1, double* y1, double* t1, double delta, double* pathx, double* pathy, double* patht, int n)
+{
+	int i;
+	double va1, va2, l, newval, incrt, remain, step, thresh;
+	double center_x, center_y;
+	double x2, y2, t2;
+	int nnew;
+
+	/* segments of length 0 add no point */
+	if (ty == 3)
+	{
+		if (fabs(val / ctx->radcurv)<EPS4) return(n);
+	}
+	else
+	{
+		if (fabs(val)<EPS4) return(n);
+	}
+
+	switch (ty)
+	{
+	case 1: /* circular arc toward the right */
+		center_x = *x1 + ctx->radcurv * sin(*t1);
+		center_y = *y1 - ctx->radcurv * cos(*t1);
+		va1 = *t1 + MPIDIV2;
+		if (orientation == 1) va2 = va1 - val;
+		else va2 = va1 + val;
+		x2 = center_x + ctx->radcurv * cos(va2);
+		y2 = center_y + ctx->radcurv * sin(va2);
+		t2 = *t1 - orientation * val;
+
+		nnew = val / delta;
+		remain = val - nnew * delta;
+		nnew = nnew + n;
+
+		if (orientation == -1) delta = -delta;
+		incrt = 0;
+		for (i = n; i<nnew; i++)
+		{
+			va1 = va1 - delta;
+			*(pathx + i) = center_x + ctx->radcurv * cos(va1);
+			*(pathy + i) = center_y + ctx->radcurv * sin(va1);
+			incrt = incrt - delta;
+			*(patht + i) = mod2pi(*t1 + incrt);
+		}
+		n = nnew;
+		if (remain > fabs(delta) / 5.)
+		{
+			*(pathx + nnew) = x2;
+			*(pathy + nnew) = y2;
+			*(patht + nnew) = mod2pi(t2);
+			n++;
+		}
+		else
+		{
+			*(pathx + nnew - 1) = x2;
+			*(pathy + nnew - 1) = y2;
+			*(patht + nnew - 1) = mod2pi(t2);
+		}
+		break;
+
+	case 2: /* circular arc toward the left */
+		center_x = *x1 - ctx->radcurv * sin(*t1);
+		center_y = *y1 + ctx->radcurv * cos(*t1);
+		va1 = *t1 - MPIDIV2;
+		if (orientation == 1) va2 = va1 + val;
+		else va2 = va1 - val;
+		x2 = center_x + ctx->radcurv * cos(va2);
+		y2 = center_y + ctx->radcurv * sin(va2);
+		t2 = *t1 + orientation * val;
+
+		nnew = val / delta;
+		remain = val - nnew * delta;
+		nnew = nnew + n;
+
+		if (orientation == -1) delta = -delta;
+		incrt = 0;
+		for (i = n; i<nnew; i++)
+		{
+			va1 = va1 + delta;
+			*(pathx + i) = center_x + ctx->radcurv * cos(va1);
+			*(pathy + i) = center_y + ctx->radcurv * sin(va1);
+			incrt = incrt + delta;
+			*(patht + i) = mod2pi(*t1 + incrt);
+		}
+		n = nnew;
+		if (remain > fabs(delta) / 5.)
+		{
+			*(pathx + nnew) = x2;
+			*(pathy + nnew) = y2;
+			*(patht + nnew) = mod2pi(t2);
+			n++;
+		}
+		else
+		{
+			*(pathx + nnew - 1) = x2;
+			*(pathy + nnew - 1) = y2;
+			*(patht + nnew - 1) = mod2pi(t2);
+		}
+		break;
+
+	case 3: /* straight line */
+		x2 = *x1 + orientation * val*cos(*t1);
+		y2 = *y1 + orientation * val*sin(*t1);
+		*t1 = mod2pi(*t1);
+		t2 = *t1;
+
+		/* sampling step along the line, and shortest last step */
+		if (ctx->sampling == RS_SAMPLING_UNIFORM)
+		{
+			step = ctx->radcurv * delta;
+			thresh = step / 5.;
+		}
+		else
+		{
+			step = 1.2;
+			thresh = 0.4;
+		}
+
+		va1 = sqrt((x2 - *x1)*(x2 - *x1) + (y2 - *y1)*(y2 - *y1));
+		i = va1 / step;
+		remain = va1 - i * step;
+		nnew = n + i;
+		newval = step;
+		va1 = orientation * cos(*t1);
+		va2 = orientation * sin(*t1);
+		for (i = n; i<nnew; i++)
+		{
+			*(pathx + i) = *x1 + va1 * newval;
+			*(pathy + i) = *y1 + va2 * newval;
+			*(patht + i) = *t1;
+			newval = newval + step;
+		}
+		if (remain > thresh)
+		{
+			*(pathx + nnew) = x2;
+			*(pathy + nnew) = y2;
+			*(patht + nnew) = t2;
+			n = nnew + 1;
+		}
+		else
+		{
+			*(pathx + nnew - 1) = x2;
+			*(pathy + nnew - 1) = y2;
+			*(patht + nnew - 1) = t2;
+			n = nnew;
+		}
+	}
+
+	*x1 = x2;
+	*y1 = y2;
+	*t1 = t2;
+
+	return(n);
+}
+
+
+/***********************************************************/
+EXPORT
+int constRS_ctx(const rs_context* ctx, int num, double t, double u, double v, double x1, double y1, double t1, double delta, double* pathx, double* pathy, double* patht)
+{
+	const rs_segment* seg;
+	double lengths[4];
+	int i, n;
+
+	*pathx = x1;
+	*pathy = y1;
+	*patht = t1;
+	n = 1;
+
+	if ((num < 1) || (num > 48))
+	{
+		printf("Error: RS curve type %d unknown\n", num);
+		return n;
+	}
+
+	lengths[RS_T] = t;
+	lengths[RS_U] = u;
+	lengths[RS_V] = v;
+	lengths[RS_HALFPI] = MPIDIV2;
+
+	/* the segments of the curve, as listed in rs_words */
+	for (i = 0; (i < RS_MAX_SEGMENTS) && (rs_words[num - 1][i].type != 0); i++)
+	{
+		seg = &rs_words[num - 1][i];
+		n = fct_curve(ctx, seg->type, seg->orientation, lengths[seg->length], &x1, &y1, &t1, delta, pathx, pathy, patht, n);
+	}
+
+	if (__atomic_load_n(&rs_stats_enabled, __ATOMIC_RELAXED)) rs_stats_add_path(n);
+	return n;
+}
+
+
+/***********************************************************/
+EXPORT
+int constRS(int num, double t, double u, double v, double x1, double y1, double t1, double delta, double* pathx, double* pathy, double* patht)
+{
+	return(constRS_ctx(&rs_default, num, t, u, v, x1, y1, t1, delta, pathx, pathy, patht));
+}
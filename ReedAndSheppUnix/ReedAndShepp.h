@@ -0,0 +1,485 @@
+// ReedAndShepp.h : exported functions of the ReedAndShepp library.
+//
+
+#ifndef REEDANDSHEPP_H
+#define REEDANDSHEPP_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Sets the turning radius used by all the functions below. */
+void change_radcurv(double radcurv);
+
+/*
+An rs_context carries its own turning radius. The functions ending in
+_ctx take one instead of using the radius set by change_radcurv, and
+only read it: threads can share a context, or each use its own, without
+any locking.
+*/
+typedef struct rs_context rs_context;
+
+rs_context* rs_context_create(double radcurv);
+void rs_context_destroy(rs_context* ctx);
+
+/*
+Computes the shortest RS curve from (x1,y1,t1) to (x2,y2,t2). Returns its
+length and puts in numero the number (1 to 48) of the curve and in tr, ur
+and vr its parameters.
+*/
+double reed_shepp(double x1, double y1, double t1, double x2, double y2, double t2, int* numero, double* tr, double* ur, double* vr);
+
+double reed_shepp_ctx(const rs_context* ctx, double x1, double y1, double t1, double x2, double y2, double t2, int* numero, double* tr, double* ur, double* vr);
+
+/*
+Returns only the length of the shortest RS curve, skipping the curves
+that cannot be shorter than the best one found so far.
+*/
+double reed_shepp_length(double x1, double y1, double t1, double x2, double y2, double t2);
+double reed_shepp_length_ctx(const rs_context* ctx, double x1, double y1, double t1, double x2, double y2, double t2);
+
+/*
+Computes the k shortest RS curves from (x1,y1,t1) to (x2,y2,t2), among
+the ones that exist, and writes them by increasing length in the arrays
+length, numero, tr, ur and vr of k elements. Returns their number, which
+is less than k when fewer curves exist. The first one is the curve of
+reed_shepp. The functions of families of curves return INFINITY (10000)
+for the curves that do not exist, so the curves of 10000 units of length
+or more are taken as not existing: for configurations that far apart,
+it returns 0 where reed_shepp still gives a curve.
+*/
+int reed_shepp_topk(double x1, double y1, double t1, double x2, double y2, double t2, int k,
+	double* length, int* numero, double* tr, double* ur, double* vr);
+int reed_shepp_topk_ctx(const rs_context* ctx, double x1, double y1, double t1, double x2, double y2, double t2, int k,
+	double* length, int* numero, double* tr, double* ur, double* vr);
+
+/*
+reed_shepp_filtered computes the shortest RS curve among the ones of
+mask, whose bit num - 1 (RS_MASK_WORD(num)) is set when the curve number
+num is allowed; the other curves are not computed. Returns -1, and 0 in
+numero, when none of them exists. Like reed_shepp_topk, it takes the
+curves of 10000 units of length or more as not existing, so it also
+returns -1 for configurations that far apart.
+
+rs_mask_no_reverse gives the curves driven forward only, rs_mask_max_cusps
+the ones with at most cusps changes of direction, and rs_mask_csc the
+ones made of an arc, a straight line and an arc. Masks combine with & and
+|.
+*/
+#define RS_MASK_WORD(num) (1ULL << ((num) - 1))
+#define RS_MASK_ALL 0xFFFFFFFFFFFFULL
+
+double reed_shepp_filtered(double x1, double y1, double t1, double x2, double y2, double t2, unsigned long long mask,
+	int* numero, double* tr, double* ur, double* vr);
+double reed_shepp_filtered_ctx(const rs_context* ctx, double x1, double y1, double t1, double x2, double y2, double t2, unsigned long long mask,
+	int* numero, double* tr, double* ur, double* vr);
+unsigned long long rs_mask_no_reverse(void);
+unsigned long long rs_mask_max_cusps(int cusps);
+unsigned long long rs_mask_csc(void);
+
+/*
+An rs_cost weighs the segments of the RS curves: the cost of a segment is
+its length times the weight of its kind (arc or straight line, driven
+forward or in reverse), and each change of direction adds cusp.
+reed_shepp_weighted computes the RS curve of smallest cost, among the 48,
+and returns its cost. With all the weights 1 and cusp 0 it is the curve
+of reed_shepp. Like reed_shepp_topk, it takes the curves of 10000 units
+of length or more as not existing: for configurations that far apart, it
+returns HUGE_VAL, and 0 in numero.
+*/
+typedef struct
+{
+	double forward_arc, reverse_arc;
+	double forward_straight, reverse_straight;
+	double cusp;
+} rs_cost;
+
+double reed_shepp_weighted(double x1, double y1, double t1, double x2, double y2, double t2, const rs_cost* cost,
+	int* numero, double* tr, double* ur, double* vr);
+double reed_shepp_weighted_ctx(const rs_context* ctx, double x1, double y1, double t1, double x2, double y2, double t2, const rs_cost* cost,
+	int* numero, double* tr, double* ur, double* vr);
+
+/*
+Same as reed_shepp, but returns 0 when the two configurations are equal
+(numero, tr, ur and vr are then left unchanged).
+*/
+double min_length_rs(double x1, double y1, double t1, double x2, double y2, double t2, int* numero, double* t, double* u, double* v);
+double min_length_rs_ctx(const rs_context* ctx, double x1, double y1, double t1, double x2, double y2, double t2, int* numero, double* t, double* u, double* v);
+
+/*
+Same as reed_shepp for n queries at once. The inputs and outputs are
+arrays of n elements (structure of arrays), owned by the caller.
+*/
+void reed_shepp_batch(int n, const double* x1, const double* y1, const double* t1, const double* x2, const double* y2, const double* t2,
+	double* length, int* numero, double* tr, double* ur, double* vr);
+void reed_shepp_batch_ctx(const rs_context* ctx, int n, const double* x1, const double* y1, const double* t1, const double* x2, const double* y2, const double* t2,
+	double* length, int* numero, double* tr, double* ur, double* vr);
+
+/*
+reed_shepp_f and reed_shepp_batch_f are reed_shepp and reed_shepp_batch in
+single precision, with twice as many queries per vector. On random
+queries up to 100 radii apart, for radii from 0.3 to 2.5, their lengths
+were within 2e-4 * (radcurv + length) of the double ones, and within
+4e-7 * (radcurv + length) for 99 % of them; the largest errors are near
+the limits where curves stop existing. The queries whose curve is
+shorter than the radius, where the single precision scan is least
+precise, are solved again in double. The coordinates are rounded to
+float too, which adds an error growing with their magnitude. When two
+curves have nearly the same length, numero may differ from reed_shepp.
+
+reed_shepp_mixed and reed_shepp_batch_mixed pick the curve in single
+precision and compute only this curve in double: t, u, v and the length
+are the ones of this curve computed in double, and the query is solved
+again in double when the two precisions disagree on its length or when
+it is shorter than the radius. On the
+same queries, the length was never more than 2e-6 * (radcurv + length)
+above the one of reed_shepp.
+*/
+float reed_shepp_f(float x1, float y1, float t1, float x2, float y2, float t2, int* numero, float* tr, float* ur, float* vr);
+float reed_shepp_f_ctx(const rs_context* ctx, float x1, float y1, float t1, float x2, float y2, float t2, int* numero, float* tr, float* ur, float* vr);
+void reed_shepp_batch_f(int n, const float* x1, const float* y1, const float* t1, const float* x2, const float* y2, const float* t2,
+	float* length, int* numero, float* tr, float* ur, float* vr);
+void reed_shepp_batch_f_ctx(const rs_context* ctx, int n, const float* x1, const float* y1, const float* t1, const float* x2, const float* y2, const float* t2,
+	float* length, int* numero, float* tr, float* ur, float* vr);
+double reed_shepp_mixed(double x1, double y1, double t1, double x2, double y2, double t2, int* numero, double* tr, double* ur, double* vr);
+double reed_shepp_mixed_ctx(const rs_context* ctx, double x1, double y1, double t1, double x2, double y2, double t2, int* numero, double* tr, double* ur, double* vr);
+void reed_shepp_batch_mixed(int n, const double* x1, const double* y1, const double* t1, const double* x2, const double* y2, const double* t2,
+	double* length, int* numero, double* tr, double* ur, double* vr);
+void reed_shepp_batch_mixed_ctx(const rs_context* ctx, int n, const double* x1, const double* y1, const double* t1, const double* x2, const double* y2, const double* t2,
+	double* length, int* numero, double* tr, double* ur, double* vr);
+
+/*
+An rs_table holds the lengths of the shortest RS curves on a grid of
+increments of configuration, normalized by the turning radius, so one
+table serves every radius. rs_table_build computes one for |x| and |y|
+up to xmax and ymax turning radii (nx, ny and nphi points along x, y and
+phi) and writes it to a file; it returns 0 on failure. rs_table_open maps
+the file in memory and returns NULL on failure.
+
+reed_shepp_table_length interpolates the length in the table. It falls
+back to reed_shepp_length outside of the table, or when table is NULL.
+*/
+typedef struct rs_table rs_table;
+
+int rs_table_build(const char* path, int nx, int ny, int nphi, double xmax, double ymax);
+rs_table* rs_table_open(const char* path);
+void rs_table_close(rs_table* table);
+double reed_shepp_table_length(const rs_table* table, double x1, double y1, double t1, double x2, double y2, double t2);
+double reed_shepp_table_length_ctx(const rs_table* table, const rs_context* ctx, double x1, double y1, double t1, double x2, double y2, double t2);
+
+/*
+An rs_cache keeps the results of recent queries of reed_shepp, keyed on
+the increment of configuration between the two configurations and the
+turning radius. With quantum and quantum_phi positive, increments are
+rounded to multiples of them (in units of length and radians) and the
+result is the one of the rounded increment; with 0, only exact repeats
+hit. capacity is the number of results kept. rs_cache_create returns NULL
+on failure. A cache can be shared by threads.
+
+rs_cache_stats gives the number of hits and misses since the creation of
+the cache or the last rs_cache_clear.
+*/
+typedef struct rs_cache rs_cache;
+
+rs_cache* rs_cache_create(int capacity, double quantum, double quantum_phi);
+void rs_cache_destroy(rs_cache* cache);
+void rs_cache_clear(rs_cache* cache);
+void rs_cache_stats(rs_cache* cache, unsigned long long* hits, unsigned long long* misses);
+double reed_shepp_cached(rs_cache* cache, double x1, double y1, double t1, double x2, double y2, double t2, int* numero, double* tr, double* ur, double* vr);
+double reed_shepp_cached_ctx(rs_cache* cache, const rs_context* ctx, double x1, double y1, double t1, double x2, double y2, double t2, int* numero, double* tr, double* ur, double* vr);
+double min_length_rs_cached(rs_cache* cache, double x1, double y1, double t1, double x2, double y2, double t2, int* numero, double* t, double* u, double* v);
+double min_length_rs_cached_ctx(rs_cache* cache, const rs_context* ctx, double x1, double y1, double t1, double x2, double y2, double t2, int* numero, double* t, double* u, double* v);
+
+/*
+reed_shepp_matrix computes the lengths of the shortest RS curves from the
+n configurations (x1[i],y1[i],t1[i]) to the m configurations
+(x2[j],y2[j],t2[j]) and writes them in out[i * m + j], out being an array
+of n * m doubles owned by the caller (it may be a file mapped in memory).
+With band RS_MATRIX_UPPER only the lengths with j >= i are written, with
+RS_MATRIX_LOWER only the ones with j <= i, and with RS_MATRIX_FULL all of
+them. The work is split over nthreads threads, or one per processor when
+nthreads is 0. When progress is not NULL, it is called from the calling
+thread with user, the number of tiles computed and the total number of
+tiles. Returns 0 on failure.
+*/
+#define RS_MATRIX_FULL 0
+#define RS_MATRIX_UPPER 1
+#define RS_MATRIX_LOWER 2
+
+typedef void (*rs_progress_fn)(void* user, long long done, long long total);
+
+int reed_shepp_matrix(int n, const double* x1, const double* y1, const double* t1,
+	int m, const double* x2, const double* y2, const double* t2, int band, int nthreads, double* out,
+	rs_progress_fn progress, void* user);
+int reed_shepp_matrix_ctx(const rs_context* ctx, int n, const double* x1, const double* y1, const double* t1,
+	int m, const double* x2, const double* y2, const double* t2, int band, int nthreads, double* out,
+	rs_progress_fn progress, void* user);
+
+/*
+An rs_index holds configurations, numbered from 0 in the order of
+rs_index_insert, and finds the closest ones to a query configuration for
+the length of the RS curves (computed with the radius of the context at
+the creation of the index). cell is the side of the cells of the grid
+the configurations are put in; about the usual distance of the
+neighbours searched is a good value. rs_index_insert returns the number of
+the configuration, or -1 when memory runs out or when x / cell or
+y / cell is NaN or beyond 2^30 in absolute value.
+
+rs_index_knn writes the numbers and lengths of the (at most) k closest
+configurations in ids and lengths, by increasing length, and returns how
+many it wrote. rs_index_radius finds the configurations at a length of at
+most radius, writes at most capacity of them, in no particular order, and
+returns their total number. Queries only read the index: threads may run
+them at the same time, but not while a configuration is inserted.
+*/
+typedef struct rs_index rs_index;
+
+rs_index* rs_index_create(double cell);
+rs_index* rs_index_create_ctx(const rs_context* ctx, double cell);
+void rs_index_destroy(rs_index* index);
+int rs_index_insert(rs_index* index, double x, double y, double theta);
+int rs_index_size(const rs_index* index);
+int rs_index_knn(const rs_index* index, double x, double y, double theta, int k, int* ids, double* lengths);
+int rs_index_radius(const rs_index* index, double x, double y, double theta, double radius, int capacity, int* ids, double* lengths);
+
+/*
+Returns the instruction set used by reed_shepp_batch: "scalar", "sse42",
+"avx2" or "avx512". It is chosen when the library is loaded, from what
+the CPU supports and the environment variable RS_ISA.
+*/
+const char* rs_isa(void);
+
+/*
+Ways constRS places the points on straight lines. Arcs always have a point
+every delta radians. With RS_SAMPLING_LEGACY, the default, straight lines
+have a point every 1.2 units of length whatever delta is. With
+RS_SAMPLING_UNIFORM, they have a point every radcurv * delta units, the
+same spacing as on the arcs. change_sampling sets it for the functions
+without a context, and rs_context_set_sampling for a context, before it is
+shared.
+*/
+#define RS_SAMPLING_LEGACY 0
+#define RS_SAMPLING_UNIFORM 1
+
+void change_sampling(int sampling);
+void rs_context_set_sampling(rs_context* ctx, int sampling);
+
+/*
+Ways reed_shepp scans the 48 RS curves. With RS_SCAN_FULL, the default,
+it computes all of them, with the vector instructions of rs_isa. With
+RS_SCAN_CANONICAL, it reflects the increment so that x >= 0 and y >= 0,
+computes first the curves that are usually the shortest there, and the
+other ones only when their lower bound does not rule them out. It then
+computes about 23 curves instead of 48, without vector instructions, and
+finds the same curves as the scalar scan (RS_ISA=scalar), ties included.
+It is meant for the CPUs without SSE4.2 and the builds without
+ReedAndShepp_simd.c. change_scan sets it for the functions without a
+context, and rs_context_set_scan for a context, before it is shared. It
+applies to reed_shepp, reed_shepp_batch and their single and mixed
+precision versions.
+*/
+#define RS_SCAN_FULL 0
+#define RS_SCAN_CANONICAL 1
+
+void change_scan(int scan);
+void rs_context_set_scan(rs_context* ctx, int scan);
+
+/*
+Computes the discretized path of the RS curve number num, parameters t, u
+and v, starting at (x1,y1,t1). Returns the number of points written in
+pathx, pathy and patht.
+*/
+int constRS(int num, double t, double u, double v, double x1, double y1, double t1, double delta, double* pathx, double* pathy, double* patht);
+int constRS_ctx(const rs_context* ctx, int num, double t, double u, double v, double x1, double y1, double t1, double delta, double* pathx, double* pathy, double* patht);
+
+/*
+constRS_count returns the number of points constRS writes for the same
+parameters, so that the arrays can be sized exactly. The start (x1,y1,t1)
+is needed because the rounding of the positions can change the count by
+one.
+
+constRS_bounded writes at most capacity points, the first ones constRS
+would write, and returns their number. It sets *truncated to 1 when the
+path has more points, and to 0 otherwise.
+*/
+int constRS_count(int num, double t, double u, double v, double x1, double y1, double t1, double delta);
+int constRS_count_ctx(const rs_context* ctx, int num, double t, double u, double v, double x1, double y1, double t1, double delta);
+int constRS_bounded(int num, double t, double u, double v, double x1, double y1, double t1, double delta,
+	int capacity, double* pathx, double* pathy, double* patht, int* truncated);
+int constRS_bounded_ctx(const rs_context* ctx, int num, double t, double u, double v, double x1, double y1, double t1, double delta,
+	int capacity, double* pathx, double* pathy, double* patht, int* truncated);
+
+/*
+An rs_path describes an RS curve, or a sequence of them, by its start and
+its segments: arcs toward the right (RS_RIGHT) or the left (RS_LEFT) of
+radius radcurv, or straight lines (RS_STRAIGHT), each one driven forward
+(direction 1) or backward (-1) for a length in units of length. It is a
+plain structure, without pointers, that can be copied as is.
+
+reed_shepp_path computes the shortest RS curve like reed_shepp and returns
+it as a path. rs_path_from_word builds the path of the curve number num,
+parameters t, u and v, as given by reed_shepp; it returns 0 when num is
+not a curve number.
+
+rs_path_eval computes the pose at the length s along the path, s being
+clamped to the path. rs_path_sample computes poses every step units of
+length from the start, plus the end, writes at most capacity of them and
+returns their total number, or 0 when step is not positive or is so small
+that the number does not fit in an int. rs_path_reverse gives the path driven from the
+end back to the start. rs_path_split cuts the path at the length s.
+rs_path_concat appends b, taken to start at the end of a, to a; it returns
+0 when the radii differ or the result has more than RS_PATH_MAX_SEGMENTS
+segments.
+*/
+#define RS_RIGHT 1
+#define RS_LEFT 2
+#define RS_STRAIGHT 3
+
+#define RS_PATH_MAX_SEGMENTS 16
+
+typedef struct
+{
+	int type;
+	int direction;
+	double length;
+} rs_path_segment;
+
+typedef struct
+{
+	double x, y, theta;
+	double radcurv;
+	int nsegments;
+	rs_path_segment segments[RS_PATH_MAX_SEGMENTS];
+} rs_path;
+
+double reed_shepp_path(double x1, double y1, double t1, double x2, double y2, double t2, rs_path* path);
+double reed_shepp_path_ctx(const rs_context* ctx, double x1, double y1, double t1, double x2, double y2, double t2, rs_path* path);
+int rs_path_from_word(rs_path* path, int num, double t, double u, double v, double x1, double y1, double t1);
+int rs_path_from_word_ctx(const rs_context* ctx, rs_path* path, int num, double t, double u, double v, double x1, double y1, double t1);
+double rs_path_length(const rs_path* path);
+void rs_path_eval(const rs_path* path, double s, double* x, double* y, double* theta);
+int rs_path_sample(const rs_path* path, double step, int capacity, double* pathx, double* pathy, double* patht);
+void rs_path_reverse(const rs_path* path, rs_path* reversed);
+void rs_path_split(const rs_path* path, double s, rs_path* first, rs_path* second);
+int rs_path_concat(const rs_path* a, const rs_path* b, rs_path* path);
+
+/*
+An rs_grid is an occupancy grid of width x height square cells of side
+resolution, the corner of the cell (0,0) being at (originx,originy) and
+the cell (i,j) at index j * width + i. It is either a bitmap (occupancy,
+non zero for an occupied cell) or a distance field (distance, the distance
+from the center of each cell to the closest obstacle); distance is used
+when it is not NULL. The arrays are owned by the caller.
+
+The footprint of the robot is a set of ncircles circles, the center of
+each one given in the frame of the robot (x forward, y to the left).
+
+rs_path_collision_free checks the footprint along the path, at poses
+close enough for the circles to move by at most half a cell between two
+of them (farther apart where a distance field shows they can), with the
+radius of the circles enlarged by a quarter of a cell so that obstacles
+between two poses are found too. It stops at
+the first collision and returns 0, or returns 1 when the path is free.
+When free_length is not NULL, it receives the length of the path checked
+free before the collision (the length of the path when there is none).
+Leaving the grid is a collision. rs_collision_free does the same for the
+RS curve number num, parameters t, u and v, starting at (x1,y1,t1).
+*/
+typedef struct
+{
+	int width, height;
+	double resolution;
+	double originx, originy;
+	const unsigned char* occupancy;
+	const float* distance;
+} rs_grid;
+
+typedef struct
+{
+	double x, y, radius;
+} rs_circle;
+
+int rs_path_collision_free(const rs_path* path, const rs_circle* footprint, int ncircles, const rs_grid* grid, double* free_length);
+int rs_collision_free(int num, double t, double u, double v, double x1, double y1, double t1,
+	const rs_circle* footprint, int ncircles, const rs_grid* grid, double* free_length);
+int rs_collision_free_ctx(const rs_context* ctx, int num, double t, double u, double v, double x1, double y1, double t1,
+	const rs_circle* footprint, int ncircles, const rs_grid* grid, double* free_length);
+
+/*
+rs_pose_at computes the pose at the length s along the RS curve number
+num, parameters t, u and v, starting at (x1,y1,t1), without discretizing
+it. s is clamped to the curve (0 gives the start, the length of the curve
+or more gives the end). Returns 0, with the start pose, when num is not a
+curve number.
+*/
+int rs_pose_at(int num, double t, double u, double v, double x1, double y1, double t1, double s,
+	double* x, double* y, double* theta);
+int rs_pose_at_ctx(const rs_context* ctx, int num, double t, double u, double v, double x1, double y1, double t1, double s,
+	double* x, double* y, double* theta);
+
+/*
+An rs_cursor gives the points of the discretized path of constRS one at a
+time, without any buffer: rs_cursor_init takes the same parameters as
+constRS, and each call to rs_cursor_next writes the next point in x, y and
+theta and returns 1, or returns 0 after the last one. The points are the
+ones constRS would write. The fields of rs_cursor are private.
+*/
+typedef struct rs_cursor
+{
+	double radcurv, delta, line_step, line_threshold;
+	double lengths[4];
+	int num, segment, phase, step, nsteps;
+	double x, y, theta;
+	double cx, cy, angle, dangle, incrt;
+	double x2, y2, t2, remain, threshold;
+	double px, py, pt;
+} rs_cursor;
+
+void rs_cursor_init(rs_cursor* cursor, int num, double t, double u, double v, double x1, double y1, double t1, double delta);
+void rs_cursor_init_ctx(rs_cursor* cursor, const rs_context* ctx, int num, double t, double u, double v, double x1, double y1, double t1, double delta);
+int rs_cursor_next(rs_cursor* cursor, double* x, double* y, double* theta);
+
+/*
+Counters of the solver, off by default. Once rs_stats_enable(1) is called,
+reed_shepp, reed_shepp_batch (and the functions built on them, such as
+min_length_rs and reed_shepp_matrix), constRS and constRS_bounded count,
+in every thread:
+- queries: the configurations solved,
+- wins: how many times each curve (wins[numero - 1]) was the shortest,
+- sampled: the queries, one in 64 in each thread, for which the
+  rejections are counted,
+- rejections: how many times, for the sampled queries, a curve of each
+  family of 4 curves, in the order of rs_words, does not exist (its
+  function returns INFINITY),
+- paths and samples: the calls to constRS and the points they wrote,
+- cycles: the time spent in the scan of the 48 curves, in time stamp
+  counter ticks on x86 and in nanoseconds elsewhere.
+The rejections are counted by a second scan of the sampled queries,
+outside the time measured, which costs about one scalar scan of the 48
+curves every 64 queries.
+rejections[f] / (4 * sampled) estimates the share of the curves of the
+family f that do not exist.
+
+rs_stats_snapshot adds up the counters of all the threads, including the
+ones that ended, and rs_stats_reset sets them to 0.
+*/
+typedef struct
+{
+	unsigned long long queries;
+	unsigned long long wins[48];
+	unsigned long long sampled;
+	unsigned long long rejections[12];
+	unsigned long long paths;
+	unsigned long long samples;
+	unsigned long long cycles;
+} rs_stats;
+
+void rs_stats_enable(int enabled);
+void rs_stats_snapshot(rs_stats* stats);
+void rs_stats_reset(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
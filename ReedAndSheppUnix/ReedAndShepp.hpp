@@ -0,0 +1,299 @@
+// ReedAndShepp.hpp : header-only C++ version of the solver of ReedAndShepp.c.
+//
+
+#ifndef REEDANDSHEPP_HPP
+#define REEDANDSHEPP_HPP
+
+#include <cmath>
+#include <ratio>
+
+/*
+
+ReedsShepp<Scalar, Radius> computes the shortest RS curve like reed_shepp,
+with the same 12 functions of families of curves, in the type Scalar
+(float or double). Everything is inline, so the compiler can specialize
+the solver for the caller.
+
+Radius is the turning radius, either fixed at compile time as a
+std::ratio (for instance std::ratio<5, 2> for 2.5), in which case the
+constants derived from it are folded in the code, or rs_runtime_radius
+for a radius given to the constructor:
+
+	ReedsShepp<float, std::ratio<5, 2> > fixed;
+	ReedsShepp<double> runtime(2.5);
+
+	length = fixed.solve(x1, y1, t1, x2, y2, t2, numero, t, u, v);
+
+The curve numbers and the parameters t, u and v are the ones of
+reed_shepp, so the results can be given to constRS or rs_path_from_word.
+The functions of families of curves are the ones of ReedAndShepp_kernels.h
+and the atan, acos, asin, my_atan2 and mod2pi they call the ones of
+ReedAndShepp_math.h, both included in the solver with vd standing for
+Scalar. With double, the results are therefore the ones of the scalar
+solver of ReedAndShepp.c, except that the curves that do not exist have
+an infinite length instead of INFINITY (10000), so that curves longer
+than that are found too. With float, the lengths lose precision mostly
+near the limits where curves stop existing (acos of values close to 1),
+up to about 1e-3 radius there. As with reed_shepp_f, the increments whose
+curve is shorter than the radius, where the curve picked in float could
+be much longer than the shortest one, are solved again in double.
+
+*/
+
+struct rs_runtime_radius
+{
+};
+
+namespace rs_detail
+{
+	/* the radius and the constants of rs_context, at compile time... */
+	template <typename Scalar, typename Radius>
+	struct radius
+	{
+		static constexpr Scalar radcurv = Scalar(Radius::num) / Scalar(Radius::den);
+		static constexpr Scalar radcurvmul2 = 2 * radcurv;
+		static constexpr Scalar radcurvmul4 = 4 * radcurv;
+		static constexpr Scalar sqradcurv = radcurv * radcurv;
+		static constexpr Scalar sqradcurvmul2 = 4 * radcurv * radcurv;
+	};
+
+	template <typename Scalar, typename Radius> constexpr Scalar radius<Scalar, Radius>::radcurv;
+	template <typename Scalar, typename Radius> constexpr Scalar radius<Scalar, Radius>::radcurvmul2;
+	template <typename Scalar, typename Radius> constexpr Scalar radius<Scalar, Radius>::radcurvmul4;
+	template <typename Scalar, typename Radius> constexpr Scalar radius<Scalar, Radius>::sqradcurv;
+	template <typename Scalar, typename Radius> constexpr Scalar radius<Scalar, Radius>::sqradcurvmul2;
+
+	/* ...or at run time */
+	template <typename Scalar>
+	struct radius<Scalar, rs_runtime_radius>
+	{
+		Scalar radcurv, radcurvmul2, radcurvmul4, sqradcurv, sqradcurvmul2;
+
+		explicit radius(Scalar r)
+			: radcurv(r), radcurvmul2(2 * r), radcurvmul4(4 * r), sqradcurv(r * r), sqradcurvmul2(4 * r * r)
+		{
+		}
+	};
+
+
+	/***********************************************************/
+	/*
+	The 12 functions of families of curves of ReedAndShepp_kernels.h, and
+	the scan of the 48 curves of rs_solve, for the radius R.
+	*/
+	template <typename Scalar, typename R>
+	class solver
+	{
+	public:
+		explicit solver(const R& radius) : k(radius) {}
+
+		Scalar radcurv() const { return(k.radcurv); }
+
+		/*
+		Shortest curve for the increment (x,y,phi) in the frame of the
+		initial configuration. Returns its length.
+		*/
+		Scalar solve_increment(Scalar x, Scalar y, Scalar phi, int& numero, Scalar& t, Scalar& u, Scalar& v) const
+		{
+			Scalar sphi, cphi, ap, am, b1, b2;
+			best b;
+
+			sphi = std::sin(phi);
+			cphi = std::cos(phi);
+
+			ap = k.radcurv * sphi;
+			am = -k.radcurv * sphi;
+			b1 = k.radcurv * (cphi - 1);
+			b2 = k.radcurv * (cphi + 1);
+
+			b.length = INFINITY;
+			b.numero = 0;
+			b.t = b.u = b.v = 0;
+			b.tn = b.un = b.vn = 0;
+			b.scanned = 0;
+
+			/* same order as rs_solve: the curve 4 * f + i + 1 for the family f */
+			family<c_c_c, 0>(b, x, y, phi, ap, am, b1);
+			family<c_cc, 0>(b, x, y, phi, ap, am, b1);
+			family<csca, 1>(b, x, y, phi, ap, am, b1);
+			family<cscb, 1>(b, x, y, phi, ap, am, b2);
+			family<ccu_cuc, 1>(b, x, y, phi, ap, am, b2);
+			family<c_cucu_c, 1>(b, x, y, phi, ap, am, b2);
+			family<c_c2sca, 1>(b, x, y, phi, ap, am, b1);
+			family<c_c2scb, 1>(b, x, y, phi, ap, am, b2);
+			family<c_c2sc2_c, 1>(b, x, y, phi, ap, am, b2);
+			family<cc_c, 1>(b, x, y, phi, ap, am, b1);
+			family<csc2_ca, 1>(b, x, y, phi, ap, am, b1);
+			family<csc2_cb, 1>(b, x, y, phi, ap, am, b2);
+
+			if ((sizeof(Scalar) < sizeof(double)) && (b.length < k.radcurv))
+				return(solve_short(x, y, phi, numero, t, u, v));
+
+			numero = b.numero;
+			t = b.t;
+			u = b.u;
+			v = b.v;
+			return(b.length);
+		}
+
+		/*
+		Shortest curve from (x1,y1,t1) to (x2,y2,t2), as reed_shepp.
+		*/
+		Scalar solve(Scalar x1, Scalar y1, Scalar t1, Scalar x2, Scalar y2, Scalar t2,
+			int& numero, Scalar& t, Scalar& u, Scalar& v) const
+		{
+			Scalar dx, dy, ct, st;
+
+			dx = x2 - x1;
+			dy = y2 - y1;
+			ct = std::cos(t1);
+			st = std::sin(t1);
+			return(solve_increment(dx * ct + dy * st, dy * ct - dx * st, t2 - t1, numero, t, u, v));
+		}
+
+		/* length of the shortest curve from (x1,y1,t1) to (x2,y2,t2) */
+		Scalar length(Scalar x1, Scalar y1, Scalar t1, Scalar x2, Scalar y2, Scalar t2) const
+		{
+			Scalar t, u, v;
+			int numero;
+
+			return(solve(x1, y1, t1, x2, y2, t2, numero, t, u, v));
+		}
+
+	private:
+		/* the names used by ReedAndShepp_math.h and ReedAndShepp_kernels.h */
+		typedef Scalar vd;
+		typedef bool vm;
+		typedef R rs_context;
+		typedef vd (*curve_fn)(const rs_context* ctx, vd x, vd y, vd phi, vd rs, vd rc, vd* t, vd* u, vd* v);
+
+		/* shortest curve so far, and last curve computed */
+		struct best
+		{
+			Scalar length, t, u, v;
+			int numero;
+			Scalar tn, un, vn;
+			int scanned;
+		};
+
+		R k;
+
+		/* the increment solved again in double */
+		Scalar solve_short(Scalar x, Scalar y, Scalar phi, int& numero, Scalar& t, Scalar& u, Scalar& v) const
+		{
+			typedef radius<double, rs_runtime_radius> precise_radius;
+			solver<double, precise_radius> precise((precise_radius(k.radcurv)));
+			double length, tp, up, vp;
+
+			length = precise.solve_increment(x, y, phi, numero, tp, up, vp);
+			t = Scalar(tp);
+			u = Scalar(up);
+			v = Scalar(vp);
+			return(Scalar(length));
+		}
+
+		/*
+		The 4 curves of a family, for the increments (x,y,phi), (-x,y,-phi),
+		(x,-y,-phi) and (-x,-y,phi), the second and third ones swapped when
+		swap is 1, as in rs_reflection.
+		*/
+		template <curve_fn Curve, int swap>
+		void family(best& b, Scalar x, Scalar y, Scalar phi, Scalar ap, Scalar am, Scalar rc) const
+		{
+			if (swap)
+			{
+				candidate(b, Curve(&k, x, y, phi, ap, rc, &b.tn, &b.un, &b.vn));
+				candidate(b, Curve(&k, x, -y, -phi, am, rc, &b.tn, &b.un, &b.vn));
+				candidate(b, Curve(&k, -x, y, -phi, am, rc, &b.tn, &b.un, &b.vn));
+				candidate(b, Curve(&k, -x, -y, phi, ap, rc, &b.tn, &b.un, &b.vn));
+			}
+			else
+			{
+				candidate(b, Curve(&k, x, y, phi, ap, rc, &b.tn, &b.un, &b.vn));
+				candidate(b, Curve(&k, -x, y, -phi, am, rc, &b.tn, &b.un, &b.vn));
+				candidate(b, Curve(&k, x, -y, -phi, am, rc, &b.tn, &b.un, &b.vn));
+				candidate(b, Curve(&k, -x, -y, phi, ap, rc, &b.tn, &b.un, &b.vn));
+			}
+		}
+
+		/* keeps the first of the shortest curves, the curve computed being the next one */
+		static void candidate(best& b, Scalar var)
+		{
+			int num;
+
+			num = b.scanned + 1;
+			b.scanned = num;
+			if ((num == 1) || (var < b.length))
+			{
+				b.length = var;
+				b.numero = num;
+				b.t = b.tn;
+				b.u = b.un;
+				b.v = b.vn;
+			}
+		}
+
+		/* the primitives of ReedAndShepp_math.h on Scalar */
+		static vd vd_set1(double a) { return(Scalar(a)); }
+		static vd vd_add(vd a, vd b) { return(a + b); }
+		static vd vd_sub(vd a, vd b) { return(a - b); }
+		static vd vd_mul(vd a, vd b) { return(a * b); }
+		static vd vd_div(vd a, vd b) { return(a / b); }
+		static vd vd_sqrt(vd a) { return(std::sqrt(a)); }
+		static vd vd_abs(vd a) { return(std::fabs(a)); }
+		static vd vd_floor(vd a) { return(std::floor(a)); }
+		static vd vd_neg(vd a) { return(-a); }
+		static vm vd_lt(vd a, vd b) { return(a < b); }
+		static vm vd_gt(vd a, vd b) { return(a > b); }
+		static vm vd_ge(vd a, vd b) { return(a >= b); }
+		static vm vd_eq(vd a, vd b) { return(a == b); }
+		static vm vm_and(vm a, vm b) { return(a && b); }
+		static vm vm_andnot(vm a, vm b) { return((!a) && b); }
+		/* m ? a : b */
+		static vd vd_sel(vm m, vd a, vd b) { return(m ? a : b); }
+
+		/* sqrt and fabs of the kernels, in the precision of Scalar */
+		static vd sqrt(vd a) { return(std::sqrt(a)); }
+		static vd fabs(vd a) { return(std::fabs(a)); }
+
+#define EPS3 Scalar(1.0e-12)
+#define MPI Scalar(3.1415926536)
+#define MPIMUL2 Scalar(6.2831853072)
+#define MPIDIV2 Scalar(1.5707963268)
+#define RS_KERNEL static
+#include "ReedAndShepp_math.h"
+#include "ReedAndShepp_kernels.h"
+#undef RS_KERNEL
+#undef MPIDIV2
+#undef MPIMUL2
+#undef MPI
+#undef EPS3
+	};
+}
+
+
+/***********************************************************/
+/*
+The solver for a radius fixed at compile time...
+*/
+template <typename Scalar, typename Radius = rs_runtime_radius>
+class ReedsShepp : public rs_detail::solver<Scalar, rs_detail::radius<Scalar, Radius> >
+{
+public:
+	ReedsShepp() : rs_detail::solver<Scalar, rs_detail::radius<Scalar, Radius> >(rs_detail::radius<Scalar, Radius>()) {}
+};
+
+/*
+...and for a radius given at run time.
+*/
+template <typename Scalar>
+class ReedsShepp<Scalar, rs_runtime_radius> : public rs_detail::solver<Scalar, rs_detail::radius<Scalar, rs_runtime_radius> >
+{
+public:
+	explicit ReedsShepp(Scalar radcurv = 1)
+		: rs_detail::solver<Scalar, rs_detail::radius<Scalar, rs_runtime_radius> >(rs_detail::radius<Scalar, rs_runtime_radius>(radcurv))
+	{
+	}
+};
+
+#endif
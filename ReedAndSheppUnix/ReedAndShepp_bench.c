@@ -0,0 +1,321 @@
+// ReedAndShepp_bench.c : measures the time taken by the functions of the library.
+//
+// Built by "make bench". Every benchmark runs its function on a fixed set of
+// random queries, as many times as needed to last at least RS_BENCH_TIME
+// seconds, and prints the time per query (or per point for the paths).
+// Arguments: a substring of the names of the benchmarks to run (all when
+// there is none).
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#include "ReedAndShepp.h"
+
+#define RS_BENCH_QUERIES 4096
+#define RS_BENCH_TIME 0.5
+#define RS_BENCH_DELTA 0.05
+
+#define PI 3.14159265358979323846
+
+/*
+A set of queries: from (x1,y1,t1) to (x2,y2,t2), also rounded to float
+(fx1, ...), and the shortest RS curve of each one (for the paths).
+*/
+typedef struct
+{
+	const char* name;
+	double x1[RS_BENCH_QUERIES], y1[RS_BENCH_QUERIES], t1[RS_BENCH_QUERIES];
+	double x2[RS_BENCH_QUERIES], y2[RS_BENCH_QUERIES], t2[RS_BENCH_QUERIES];
+	float fx1[RS_BENCH_QUERIES], fy1[RS_BENCH_QUERIES], ft1[RS_BENCH_QUERIES];
+	float fx2[RS_BENCH_QUERIES], fy2[RS_BENCH_QUERIES], ft2[RS_BENCH_QUERIES];
+	int num[RS_BENCH_QUERIES];
+	double t[RS_BENCH_QUERIES], u[RS_BENCH_QUERIES], v[RS_BENCH_QUERIES];
+} rs_bench_set;
+
+/* the results, so that the compiler keeps the calls */
+static volatile double rs_bench_sink;
+static double pathx[100000], pathy[100000], patht[100000];
+
+
+/***********************************************************/
+static double now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return(ts.tv_sec + 1e-9 * ts.tv_nsec);
+}
+
+
+/***********************************************************/
+static double uniform(double a, double b)
+{
+	return(a + (b - a) * rand() / (double)RAND_MAX);
+}
+
+
+/***********************************************************/
+/*
+Fills the set with queries of the given kind, for a radius of 1:
+"near" at most 2 radii away, "far" 20 to 100 radii away, "rotation" with
+the same position and another orientation, and "boundary" with the
+centers of the first and last circles of the C | C | C curves 4 radii
+away, within 0.1 %, the limit where these curves stop existing.
+*/
+static void rs_bench_fill(rs_bench_set* set, const char* kind)
+{
+	double d, a, phi, sphi, cphi, x, y;
+	int i;
+
+	set->name = kind;
+	for (i = 0; i < RS_BENCH_QUERIES; i++)
+	{
+		set->x1[i] = uniform(-50, 50);
+		set->y1[i] = uniform(-50, 50);
+		set->t1[i] = uniform(-PI, PI);
+
+		if (strcmp(kind, "near") == 0) d = uniform(0, 2);
+		else if (strcmp(kind, "far") == 0) d = uniform(20, 100);
+		else d = 0;
+		a = uniform(-PI, PI);
+		phi = uniform(-PI, PI);
+
+		if (strcmp(kind, "boundary") == 0)
+		{
+			/* (x,y,phi) in the frame of the start, as in c_c_c */
+			sphi = sin(phi);
+			cphi = cos(phi);
+			d = 4 * uniform(0.999, 1.001);
+			x = d * cos(a) + sphi;
+			y = d * sin(a) - (cphi - 1);
+			set->x2[i] = set->x1[i] + x * cos(set->t1[i]) - y * sin(set->t1[i]);
+			set->y2[i] = set->y1[i] + x * sin(set->t1[i]) + y * cos(set->t1[i]);
+		}
+		else
+		{
+			set->x2[i] = set->x1[i] + d * cos(a);
+			set->y2[i] = set->y1[i] + d * sin(a);
+		}
+		set->t2[i] = set->t1[i] + phi;
+		set->fx1[i] = (float)set->x1[i];
+		set->fy1[i] = (float)set->y1[i];
+		set->ft1[i] = (float)set->t1[i];
+		set->fx2[i] = (float)set->x2[i];
+		set->fy2[i] = (float)set->y2[i];
+		set->ft2[i] = (float)set->t2[i];
+
+		reed_shepp(set->x1[i], set->y1[i], set->t1[i], set->x2[i], set->y2[i], set->t2[i],
+			&set->num[i], &set->t[i], &set->u[i], &set->v[i]);
+	}
+}
+
+
+/***********************************************************/
+/*
+Runs fn on the whole set until RS_BENCH_TIME has passed, and prints the
+time per unit (query or point), fn returning the number of units of one
+run.
+*/
+typedef double (*rs_bench_fn)(const rs_bench_set* set, void* arg);
+
+static void rs_bench_run(const char* name, const rs_bench_set* set, const char* filter, rs_bench_fn fn, void* arg, const char* unit)
+{
+	char full[128];
+	double start, elapsed, units;
+	long runs;
+
+	snprintf(full, sizeof(full), "%s/%s", name, set->name);
+	if ((filter != NULL) && (strstr(full, filter) == NULL)) return;
+
+	units = 0;
+	runs = 0;
+	start = now();
+	do
+	{
+		units += fn(set, arg);
+		runs++;
+		elapsed = now() - start;
+	} while (elapsed < RS_BENCH_TIME);
+
+	printf("%-32s %10.1f ns/%-6s %12.3g %s/s %8ld runs\n", full, 1e9 * elapsed / units, unit, units / elapsed, unit, runs);
+}
+
+
+/***********************************************************/
+static double bench_reed_shepp(const rs_bench_set* set, void* arg)
+{
+	double t, u, v, s;
+	int i, num;
+
+	s = 0;
+	for (i = 0; i < RS_BENCH_QUERIES; i++)
+		s += reed_shepp(set->x1[i], set->y1[i], set->t1[i], set->x2[i], set->y2[i], set->t2[i], &num, &t, &u, &v);
+	rs_bench_sink += s;
+	(void)arg;
+	return(RS_BENCH_QUERIES);
+}
+
+
+/***********************************************************/
+static double bench_min_length_rs(const rs_bench_set* set, void* arg)
+{
+	double t, u, v, s;
+	int i, num;
+
+	s = 0;
+	for (i = 0; i < RS_BENCH_QUERIES; i++)
+		s += min_length_rs(set->x1[i], set->y1[i], set->t1[i], set->x2[i], set->y2[i], set->t2[i], &num, &t, &u, &v);
+	rs_bench_sink += s;
+	(void)arg;
+	return(RS_BENCH_QUERIES);
+}
+
+
+/***********************************************************/
+static double bench_length(const rs_bench_set* set, void* arg)
+{
+	double s;
+	int i;
+
+	s = 0;
+	for (i = 0; i < RS_BENCH_QUERIES; i++)
+		s += reed_shepp_length(set->x1[i], set->y1[i], set->t1[i], set->x2[i], set->y2[i], set->t2[i]);
+	rs_bench_sink += s;
+	(void)arg;
+	return(RS_BENCH_QUERIES);
+}
+
+
+/***********************************************************/
+static double bench_batch(const rs_bench_set* set, void* arg)
+{
+	static double length[RS_BENCH_QUERIES], t[RS_BENCH_QUERIES], u[RS_BENCH_QUERIES], v[RS_BENCH_QUERIES];
+	static int num[RS_BENCH_QUERIES];
+
+	reed_shepp_batch(RS_BENCH_QUERIES, set->x1, set->y1, set->t1, set->x2, set->y2, set->t2, length, num, t, u, v);
+	rs_bench_sink += length[0];
+	(void)arg;
+	return(RS_BENCH_QUERIES);
+}
+
+
+/***********************************************************/
+static double bench_batch_f(const rs_bench_set* set, void* arg)
+{
+	static float length[RS_BENCH_QUERIES], t[RS_BENCH_QUERIES], u[RS_BENCH_QUERIES], v[RS_BENCH_QUERIES];
+	static int num[RS_BENCH_QUERIES];
+
+	reed_shepp_batch_f(RS_BENCH_QUERIES, set->fx1, set->fy1, set->ft1, set->fx2, set->fy2, set->ft2, length, num, t, u, v);
+	rs_bench_sink += length[0];
+	(void)arg;
+	return(RS_BENCH_QUERIES);
+}
+
+
+/***********************************************************/
+static double bench_batch_mixed(const rs_bench_set* set, void* arg)
+{
+	static double length[RS_BENCH_QUERIES], t[RS_BENCH_QUERIES], u[RS_BENCH_QUERIES], v[RS_BENCH_QUERIES];
+	static int num[RS_BENCH_QUERIES];
+
+	reed_shepp_batch_mixed(RS_BENCH_QUERIES, set->x1, set->y1, set->t1, set->x2, set->y2, set->t2, length, num, t, u, v);
+	rs_bench_sink += length[0];
+	(void)arg;
+	return(RS_BENCH_QUERIES);
+}
+
+
+/***********************************************************/
+/*
+One family of 4 curves: the words (arg) first to first + 3 only.
+*/
+static double bench_family(const rs_bench_set* set, void* arg)
+{
+	unsigned long long mask;
+	double t, u, v, s;
+	int i, num, first;
+
+	first = *(int*)arg;
+	mask = RS_MASK_WORD(first) | RS_MASK_WORD(first + 1) | RS_MASK_WORD(first + 2) | RS_MASK_WORD(first + 3);
+	s = 0;
+	for (i = 0; i < RS_BENCH_QUERIES; i++)
+		s += reed_shepp_filtered(set->x1[i], set->y1[i], set->t1[i], set->x2[i], set->y2[i], set->t2[i], mask, &num, &t, &u, &v);
+	rs_bench_sink += s;
+	return(RS_BENCH_QUERIES);
+}
+
+
+/***********************************************************/
+static double bench_constRS(const rs_bench_set* set, void* arg)
+{
+	double points;
+	int i;
+
+	points = 0;
+	for (i = 0; i < RS_BENCH_QUERIES; i++)
+		points += constRS(set->num[i], set->t[i], set->u[i], set->v[i], set->x1[i], set->y1[i], set->t1[i],
+			RS_BENCH_DELTA, pathx, pathy, patht);
+	rs_bench_sink += pathx[0];
+	(void)arg;
+	return(points);
+}
+
+
+/***********************************************************/
+static double bench_cursor(const rs_bench_set* set, void* arg)
+{
+	rs_cursor cursor;
+	double points, x, y, theta;
+	int i;
+
+	points = 0;
+	for (i = 0; i < RS_BENCH_QUERIES; i++)
+	{
+		rs_cursor_init(&cursor, set->num[i], set->t[i], set->u[i], set->v[i], set->x1[i], set->y1[i], set->t1[i], RS_BENCH_DELTA);
+		while (rs_cursor_next(&cursor, &x, &y, &theta)) points++;
+		rs_bench_sink += x;
+	}
+	(void)arg;
+	return(points);
+}
+
+
+/***********************************************************/
+int main(int argc, char** argv)
+{
+	static const char* kinds[4] = { "near", "far", "rotation", "boundary" };
+	static const char* families[12] = { "C|C|C", "C|CC", "CSC_a", "CSC_b", "CCu|CuC", "C|CuCu|C",
+		"C|C2SC_a", "C|C2SC_b", "C|C2SC2|C", "CC|C", "CSC2|C_a", "CSC2|C_b" };
+	static rs_bench_set set;
+	const char* filter;
+	char name[64];
+	int k, f, first;
+
+	filter = (argc > 1) ? argv[1] : NULL;
+	printf("instruction set: %s\n", rs_isa());
+	srand(1);
+
+	for (k = 0; k < 4; k++)
+	{
+		rs_bench_fill(&set, kinds[k]);
+		rs_bench_run("reed_shepp", &set, filter, bench_reed_shepp, NULL, "query");
+		rs_bench_run("min_length_rs", &set, filter, bench_min_length_rs, NULL, "query");
+		rs_bench_run("reed_shepp_length", &set, filter, bench_length, NULL, "query");
+		rs_bench_run("reed_shepp_batch", &set, filter, bench_batch, NULL, "query");
+		rs_bench_run("reed_shepp_batch_f", &set, filter, bench_batch_f, NULL, "query");
+		rs_bench_run("reed_shepp_batch_mixed", &set, filter, bench_batch_mixed, NULL, "query");
+		for (f = 0; f < 12; f++)
+		{
+			first = 4 * f + 1;
+			snprintf(name, sizeof(name), "family %s", families[f]);
+			rs_bench_run(name, &set, filter, bench_family, &first, "query");
+		}
+		rs_bench_run("constRS", &set, filter, bench_constRS, NULL, "point");
+		rs_bench_run("rs_cursor", &set, filter, bench_cursor, NULL, "point");
+	}
+
+	return(0);
+}
@@ -0,0 +1,312 @@
+// ReedAndShepp_cache.c : cache of recent results of reed_shepp.
+//
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+
+#include "ReedAndShepp.h"
+#include "ReedAndShepp_internal.h"
+
+/*
+
+An rs_cache keeps the shortest RS curves of recent increments of
+configuration (x,y,phi), the ones computed by the coordinate change of
+reed_shepp, for the turning radius they were computed with.
+
+When quantum and quantum_phi are positive, x and y are rounded to
+multiples of quantum and phi (modulo 2 * pi) to multiples of quantum_phi,
+and the curve stored is the one of the rounded increment. The result is
+then the same whichever query filled the entry. When they are 0, the
+increments must be exactly equal.
+
+The entries are split into RS_CACHE_SHARDS shards, each one with its own
+lock, so that threads seldom wait for each other. Inside a shard, a key
+may only go in one bucket of RS_CACHE_WAYS entries, and when the bucket is
+full the least recently used entry is replaced.
+
+*/
+
+#define RS_CACHE_SHARDS 64
+#define RS_CACHE_WAYS 4
+
+typedef struct
+{
+	long long kx, ky, kphi;
+	double radcurv;
+	double length, t, u, v;
+	int numero;
+	int used;
+	unsigned long long stamp;
+} rs_cache_entry;
+
+typedef struct
+{
+	pthread_mutex_t lock;
+	rs_cache_entry* entries;	/* nbuckets * RS_CACHE_WAYS */
+	unsigned long long clock;
+	unsigned long long hits;
+	unsigned long long misses;
+} rs_cache_shard;
+
+struct rs_cache
+{
+	double quantum;
+	double quantum_phi;
+	int nbuckets;		/* per shard */
+	rs_cache_shard shards[RS_CACHE_SHARDS];
+};
+
+
+/***********************************************************/
+static long long rs_cache_key(double value, double quantum)
+{
+	long long key;
+
+	if (quantum > 0) return(llround(value / quantum));
+	memcpy(&key, &value, sizeof(key));
+	return(key);
+}
+
+
+/***********************************************************/
+static unsigned long long rs_cache_hash(long long kx, long long ky, long long kphi, double radcurv)
+{
+	unsigned long long h, r;
+
+	memcpy(&r, &radcurv, sizeof(r));
+	h = (unsigned long long)kx * 0x9E3779B97F4A7C15ULL;
+	h = (h ^ (h >> 29) ^ (unsigned long long)ky) * 0xBF58476D1CE4E5B9ULL;
+	h = (h ^ (h >> 29) ^ (unsigned long long)kphi) * 0x94D049BB133111EBULL;
+	h = (h ^ (h >> 29) ^ r) * 0x9E3779B97F4A7C15ULL;
+	return(h ^ (h >> 32));
+}
+
+
+/***********************************************************/
+EXPORT
+rs_cache* rs_cache_create(int capacity, double quantum, double quantum_phi)
+{
+	rs_cache* cache;
+	int i, nbuckets;
+
+	if ((capacity < 1) || (quantum < 0) || (quantum_phi < 0)) return(NULL);
+
+	nbuckets = capacity / (RS_CACHE_SHARDS * RS_CACHE_WAYS);
+	if (nbuckets < 1) nbuckets = 1;
+
+	cache = (rs_cache*)malloc(sizeof(rs_cache));
+	if (cache == NULL) return(NULL);
+
+	cache->quantum = quantum;
+	cache->quantum_phi = quantum_phi;
+	cache->nbuckets = nbuckets;
+	for (i = 0; i < RS_CACHE_SHARDS; i++)
+	{
+		pthread_mutex_init(&cache->shards[i].lock, NULL);
+		cache->shards[i].entries = (rs_cache_entry*)calloc((size_t)nbuckets * RS_CACHE_WAYS, sizeof(rs_cache_entry));
+		cache->shards[i].clock = 0;
+		cache->shards[i].hits = 0;
+		cache->shards[i].misses = 0;
+		if (cache->shards[i].entries == NULL)
+		{
+			pthread_mutex_destroy(&cache->shards[i].lock);
+			while (--i >= 0)
+			{
+				pthread_mutex_destroy(&cache->shards[i].lock);
+				free(cache->shards[i].entries);
+			}
+			free(cache);
+			return(NULL);
+		}
+	}
+
+	return(cache);
+}
+
+
+/***********************************************************/
+EXPORT
+void rs_cache_destroy(rs_cache* cache)
+{
+	int i;
+
+	if (cache == NULL) return;
+	for (i = 0; i < RS_CACHE_SHARDS; i++)
+	{
+		pthread_mutex_destroy(&cache->shards[i].lock);
+		free(cache->shards[i].entries);
+	}
+	free(cache);
+}
+
+
+/***********************************************************/
+EXPORT
+void rs_cache_clear(rs_cache* cache)
+{
+	int i;
+
+	for (i = 0; i < RS_CACHE_SHARDS; i++)
+	{
+		pthread_mutex_lock(&cache->shards[i].lock);
+		memset(cache->shards[i].entries, 0, (size_t)cache->nbuckets * RS_CACHE_WAYS * sizeof(rs_cache_entry));
+		cache->shards[i].hits = 0;
+		cache->shards[i].misses = 0;
+		pthread_mutex_unlock(&cache->shards[i].lock);
+	}
+}
+
+
+/***********************************************************/
+EXPORT
+void rs_cache_stats(rs_cache* cache, unsigned long long* hits, unsigned long long* misses)
+{
+	int i;
+
+	*hits = 0;
+	*misses = 0;
+	for (i = 0; i < RS_CACHE_SHARDS; i++)
+	{
+		pthread_mutex_lock(&cache->shards[i].lock);
+		*hits += cache->shards[i].hits;
+		*misses += cache->shards[i].misses;
+		pthread_mutex_unlock(&cache->shards[i].lock);
+	}
+}
+
+
+/***********************************************************/
+/*
+Returns the entry of bucket holding the key, or NULL and in victim the
+entry to replace: a free one, or else the least recently used. Called
+with the lock of the shard held.
+*/
+static rs_cache_entry* rs_cache_probe(rs_cache_entry* bucket, long long kx, long long ky, long long kphi, double radcurv, rs_cache_entry** victim)
+{
+	rs_cache_entry* e;
+	int i;
+
+	*victim = bucket;
+	for (i = 0; i < RS_CACHE_WAYS; i++)
+	{
+		e = bucket + i;
+		if (e->used && (e->kx == kx) && (e->ky == ky) && (e->kphi == kphi) && (e->radcurv == radcurv)) return(e);
+		if (!e->used || ((*victim)->used && (e->stamp < (*victim)->stamp))) *victim = e;
+	}
+	return(NULL);
+}
+
+
+/***********************************************************/
+EXPORT
+double reed_shepp_cached_ctx(rs_cache* cache, const rs_context* ctx, double x1, double y1, double t1, double x2, double y2, double t2, int* numero, double* tr, double* ur, double* vr)
+{
+	double dx, dy, ct, st, x, y, phi;
+	long long kx, ky, kphi;
+	unsigned long long h;
+	rs_cache_shard* shard;
+	rs_cache_entry *bucket, *e, *victim;
+
+	/* coordinate change */
+	dx = x2 - x1;
+	dy = y2 - y1;
+	ct = cos(t1);
+	st = sin(t1);
+	x = dx * ct + dy * st;
+	y = dy * ct - dx * st;
+	phi = t2 - t1;
+
+	if (cache->quantum_phi > 0) phi = mod2pi(phi);
+	kx = rs_cache_key(x, cache->quantum);
+	ky = rs_cache_key(y, cache->quantum);
+	kphi = rs_cache_key(phi, cache->quantum_phi);
+
+	h = rs_cache_hash(kx, ky, kphi, ctx->radcurv);
+	shard = &cache->shards[h % RS_CACHE_SHARDS];
+	bucket = shard->entries + (size_t)((h / RS_CACHE_SHARDS) % cache->nbuckets) * RS_CACHE_WAYS;
+
+	pthread_mutex_lock(&shard->lock);
+	e = rs_cache_probe(bucket, kx, ky, kphi, ctx->radcurv, &victim);
+	if (e != NULL)
+	{
+		e->stamp = ++shard->clock;
+		shard->hits++;
+		*numero = e->numero;
+		*tr = e->t;
+		*ur = e->u;
+		*vr = e->v;
+		dx = e->length;
+		pthread_mutex_unlock(&shard->lock);
+		return(dx);
+	}
+	shard->misses++;
+	pthread_mutex_unlock(&shard->lock);
+
+	/* miss: solve the (rounded) increment outside of the lock */
+	if (cache->quantum > 0)
+	{
+		x = kx * cache->quantum;
+		y = ky * cache->quantum;
+	}
+	if (cache->quantum_phi > 0) phi = kphi * cache->quantum_phi;
+	dx = reed_shepp_ctx(ctx, 0.0, 0.0, 0.0, x, y, phi, numero, tr, ur, vr);
+
+	/*
+	The bucket may have changed while the lock was released: another
+	thread may have stored the same key, or taken the victim found above.
+	*/
+	pthread_mutex_lock(&shard->lock);
+	e = rs_cache_probe(bucket, kx, ky, kphi, ctx->radcurv, &victim);
+	if (e != NULL)
+	{
+		e->stamp = ++shard->clock;
+		pthread_mutex_unlock(&shard->lock);
+		return(dx);
+	}
+	victim->kx = kx;
+	victim->ky = ky;
+	victim->kphi = kphi;
+	victim->radcurv = ctx->radcurv;
+	victim->length = dx;
+	victim->t = *tr;
+	victim->u = *ur;
+	victim->v = *vr;
+	victim->numero = *numero;
+	victim->used = 1;
+	victim->stamp = ++shard->clock;
+	pthread_mutex_unlock(&shard->lock);
+
+	return(dx);
+}
+
+
+/***********************************************************/
+EXPORT
+double reed_shepp_cached(rs_cache* cache, double x1, double y1, double t1, double x2, double y2, double t2, int* numero, double* tr, double* ur, double* vr)
+{
+	return(reed_shepp_cached_ctx(cache, &rs_default, x1, y1, t1, x2, y2, t2, numero, tr, ur, vr));
+}
+
+
+/***********************************************************/
+EXPORT
+double min_length_rs_cached_ctx(rs_cache* cache, const rs_context* ctx, double x1, double y1, double t1, double x2, double y2, double t2, int* numero, double* t, double* u, double* v)
+{
+	double length_rs;
+
+	if ((fabs(x1 - x2)<EPS1) && (fabs(y1 - y2)<EPS1)
+		&& (fabs(t1 - t2)<EPS1))  length_rs = 0.0;
+	else length_rs = reed_shepp_cached_ctx(cache, ctx, x1, y1, t1, x2, y2, t2, numero, t, u, v);
+
+	return(length_rs);
+}
+
+
+/***********************************************************/
+EXPORT
+double min_length_rs_cached(rs_cache* cache, double x1, double y1, double t1, double x2, double y2, double t2, int* numero, double* t, double* u, double* v)
+{
+	return(min_length_rs_cached_ctx(cache, &rs_default, x1, y1, t1, x2, y2, t2, numero, t, u, v));
+}
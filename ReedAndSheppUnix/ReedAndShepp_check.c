@@ -0,0 +1,1068 @@
+// ReedAndShepp_check.c : compares the entry points of the library with reed_shepp.
+//
+// Built and run by "make check". The reference is reed_shepp with the
+// scalar scan, on a fixed set of random queries and for two radii. Every
+// other entry point is run on the same queries, with each instruction set
+// the CPU supports, and the number of queries where it disagrees with the
+// reference is printed. Exits with 1 when there is any.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "ReedAndShepp.h"
+#include "ReedAndShepp_internal.h"
+
+#define RS_CHECK_QUERIES 20000
+#define RS_CHECK_DELTA 0.05
+#define RS_CHECK_POINTS 100000
+#define RS_CHECK_PATHS 3000
+#define RS_CHECK_GRID 64
+#define RS_CHECK_INDEX 2000
+/* not multiples of the tiles of reed_shepp_matrix */
+#define RS_CHECK_ROWS 300
+#define RS_CHECK_COLUMNS 217
+
+/* lengths in double */
+#define RS_CHECK_TOLERANCE 1e-9
+/* ends of the curves, which lose half of the digits near the limits where the curves stop existing */
+#define RS_CHECK_TOLERANCE_GOAL 1e-7
+/* lengths of the scalar scan computed another way, same curve functions */
+#define RS_CHECK_TOLERANCE_LENGTH 1e-12
+/* lengths in single precision, see reed_shepp_f in ReedAndShepp.h */
+#define RS_CHECK_TOLERANCE_F 2e-4
+/* lengths of reed_shepp_mixed above the ones of reed_shepp */
+#define RS_CHECK_TOLERANCE_MIXED 2e-6
+
+#define PI 3.14159265358979323846
+
+/*
+The queries, from (x1,y1,t1) to (x2,y2,t2), also rounded to float, the
+shortest RS curve of each one found by the scalar reed_shepp, and the
+length it finds for the queries rounded to float.
+*/
+typedef struct
+{
+	double radcurv;
+	double x1[RS_CHECK_QUERIES], y1[RS_CHECK_QUERIES], t1[RS_CHECK_QUERIES];
+	double x2[RS_CHECK_QUERIES], y2[RS_CHECK_QUERIES], t2[RS_CHECK_QUERIES];
+	float fx1[RS_CHECK_QUERIES], fy1[RS_CHECK_QUERIES], ft1[RS_CHECK_QUERIES];
+	float fx2[RS_CHECK_QUERIES], fy2[RS_CHECK_QUERIES], ft2[RS_CHECK_QUERIES];
+	double length[RS_CHECK_QUERIES], t[RS_CHECK_QUERIES], u[RS_CHECK_QUERIES], v[RS_CHECK_QUERIES];
+	int num[RS_CHECK_QUERIES];
+	double flength[RS_CHECK_QUERIES];
+} rs_check_set;
+
+static rs_check_set set;
+static double length[RS_CHECK_QUERIES], t[RS_CHECK_QUERIES], u[RS_CHECK_QUERIES], v[RS_CHECK_QUERIES];
+static float flength[RS_CHECK_QUERIES], ft[RS_CHECK_QUERIES], fu[RS_CHECK_QUERIES], fv[RS_CHECK_QUERIES];
+static int num[RS_CHECK_QUERIES];
+static double pathx[RS_CHECK_POINTS], pathy[RS_CHECK_POINTS], patht[RS_CHECK_POINTS];
+static double boundedx[RS_CHECK_POINTS], boundedy[RS_CHECK_POINTS], boundedt[RS_CHECK_POINTS];
+static int failures;
+
+
+/***********************************************************/
+static double uniform(double a, double b)
+{
+	return(a + (b - a) * rand() / (double)RAND_MAX);
+}
+
+
+/***********************************************************/
+/*
+Fills the set with queries at every scale, three quarters of them on the
+boundaries of the symmetries of the curves, where several curves often
+have the same length: the goal on an axis of the start, a heading changed
+by a multiple of pi / 2, integer coordinates, as in
+ReedAndShepp_check_ties.c.
+*/
+static void make_set(double radcurv)
+{
+	double scale, dx, dy;
+	int i;
+
+	set.radcurv = radcurv;
+	for (i = 0; i < RS_CHECK_QUERIES; i++)
+	{
+		scale = radcurv * ((i % 3 == 0) ? 0.05 : (i % 3 == 1) ? 2 : 20);
+		set.x1[i] = uniform(-10, 10);
+		set.y1[i] = uniform(-10, 10);
+		set.t1[i] = uniform(-PI, PI);
+		dx = uniform(-scale, scale);
+		dy = uniform(-scale, scale);
+		set.t2[i] = set.t1[i] + uniform(-2 * PI, 2 * PI);
+
+		switch (i % 8)
+		{
+		case 0:
+			set.t1[i] = 0;
+			dx = 0;
+			break;
+		case 1:
+			set.t1[i] = 0;
+			dy = 0;
+			break;
+		case 2:
+			set.t2[i] = set.t1[i] + (rand() % 5 - 2) * PI / 2;
+			break;
+		case 3:
+			set.t1[i] = 0;
+			set.t2[i] = (rand() % 5 - 2) * PI / 2;
+			dx = floor(dx);
+			dy = floor(dy);
+			break;
+		case 4:
+			set.t1[i] = 0;
+			set.t2[i] = (rand() % 5 - 2) * PI / 2;
+			dx = 0;
+			break;
+		case 5:
+			set.t1[i] = 0;
+			set.t2[i] = (rand() % 5 - 2) * PI / 2;
+			dy = 0;
+			break;
+		}
+
+		set.x2[i] = set.x1[i] + dx;
+		set.y2[i] = set.y1[i] + dy;
+		set.fx1[i] = (float)set.x1[i];
+		set.fy1[i] = (float)set.y1[i];
+		set.ft1[i] = (float)set.t1[i];
+		set.fx2[i] = (float)set.x2[i];
+		set.fy2[i] = (float)set.y2[i];
+		set.ft2[i] = (float)set.t2[i];
+	}
+}
+
+
+/***********************************************************/
+static void report(const char* name, const char* isa, int bad, int n)
+{
+	printf("%-28s %-7s %6d / %d mismatches\n", name, isa, bad, n);
+	if (bad != 0) failures++;
+}
+
+
+/***********************************************************/
+/*
+Returns 1 when the curve (num,t,u,v) of length l, from the start of the
+query i, ends at its goal within RS_CHECK_TOLERANCE_GOAL * (radcurv + l).
+*/
+static int ends_at_goal(int i, double l, int num, double t, double u, double v)
+{
+	double margin, x, y, theta;
+
+	margin = RS_CHECK_TOLERANCE_GOAL * (set.radcurv + l);
+	if (!rs_pose_at(num, t, u, v, set.x1[i], set.y1[i], set.t1[i], l, &x, &y, &theta)) return(0);
+	return((fabs(x - set.x2[i]) <= margin) && (fabs(y - set.y2[i]) <= margin)
+		&& (fabs(remainder(theta - set.t2[i], 2 * PI)) <= margin / set.radcurv));
+}
+
+
+/***********************************************************/
+/*
+Returns 1 when the curve (num,t,u,v) found for the query i has the length
+of the reference, within tolerance * (radcurv + length), and goes to the
+goal of the query: it is then the curve of the reference, or another one
+just as short.
+*/
+static int same_curve(int i, double l, int num, double t, double u, double v, double tolerance)
+{
+	if (!(fabs(l - set.length[i]) <= tolerance * (set.radcurv + set.length[i]))) return(0);
+	return((num == set.num[i]) || ends_at_goal(i, l, num, t, u, v));
+}
+
+
+/***********************************************************/
+static void check_reed_shepp(const char* isa)
+{
+	int i, bad;
+
+	bad = 0;
+	for (i = 0; i < RS_CHECK_QUERIES; i++)
+	{
+		length[i] = reed_shepp(set.x1[i], set.y1[i], set.t1[i], set.x2[i], set.y2[i], set.t2[i], &num[i], &t[i], &u[i], &v[i]);
+		if (!same_curve(i, length[i], num[i], t[i], u[i], v[i], RS_CHECK_TOLERANCE)) bad++;
+	}
+	report("reed_shepp", isa, bad, RS_CHECK_QUERIES);
+
+	reed_shepp_batch(RS_CHECK_QUERIES, set.x1, set.y1, set.t1, set.x2, set.y2, set.t2, length, num, t, u, v);
+	bad = 0;
+	for (i = 0; i < RS_CHECK_QUERIES; i++)
+		if (!same_curve(i, length[i], num[i], t[i], u[i], v[i], RS_CHECK_TOLERANCE)) bad++;
+	report("reed_shepp_batch", isa, bad, RS_CHECK_QUERIES);
+}
+
+
+/***********************************************************/
+/*
+reed_shepp_length skips the curves whose lower bound is not below the
+best length found so far: a bound above the length of its curve would
+give a longer length than reed_shepp.
+*/
+static void check_length(const char* isa)
+{
+	rs_context* ctx;
+	double l;
+	int i, bad, bad_ctx;
+
+	ctx = rs_context_create(set.radcurv);
+	bad = bad_ctx = 0;
+	for (i = 0; i < RS_CHECK_QUERIES; i++)
+	{
+		l = reed_shepp_length(set.x1[i], set.y1[i], set.t1[i], set.x2[i], set.y2[i], set.t2[i]);
+		if (!(fabs(l - set.length[i]) <= RS_CHECK_TOLERANCE_LENGTH * (set.radcurv + set.length[i]))) bad++;
+		l = reed_shepp_length_ctx(ctx, set.x1[i], set.y1[i], set.t1[i], set.x2[i], set.y2[i], set.t2[i]);
+		if (!(fabs(l - set.length[i]) <= RS_CHECK_TOLERANCE_LENGTH * (set.radcurv + set.length[i]))) bad_ctx++;
+	}
+	rs_context_destroy(ctx);
+	report("reed_shepp_length", isa, bad, RS_CHECK_QUERIES);
+	report("reed_shepp_length_ctx", isa, bad_ctx, RS_CHECK_QUERIES);
+}
+
+
+/***********************************************************/
+/*
+reed_shepp_topk skips the curves whose lower bound is above the k-th
+length kept. Its first curve is the one of reed_shepp, the curves are
+sorted and all go to the goal, and the k first of the 48 are the k
+shortest.
+*/
+static void check_topk(const char* isa)
+{
+	double tlength[48], tt[48], tu[48], tv[48];
+	double klength[4], kt[4], ku[4], kv[4];
+	int tnum[48], knum[4];
+	int i, j, n, nk, bad_first, bad_sorted, bad_goal, bad_k;
+
+	bad_first = bad_sorted = bad_goal = bad_k = 0;
+	for (i = 0; i < RS_CHECK_QUERIES; i++)
+	{
+		n = reed_shepp_topk(set.x1[i], set.y1[i], set.t1[i], set.x2[i], set.y2[i], set.t2[i], 48, tlength, tnum, tt, tu, tv);
+		if ((n < 1) || !same_curve(i, tlength[0], tnum[0], tt[0], tu[0], tv[0], RS_CHECK_TOLERANCE_LENGTH)) bad_first++;
+		for (j = 1; j < n; j++)
+			if (!(tlength[j - 1] <= tlength[j])) break;
+		if (j < n) bad_sorted++;
+		for (j = 0; j < n; j++)
+			if (!ends_at_goal(i, tlength[j], tnum[j], tt[j], tu[j], tv[j])) break;
+		if (j < n) bad_goal++;
+
+		nk = reed_shepp_topk(set.x1[i], set.y1[i], set.t1[i], set.x2[i], set.y2[i], set.t2[i], 4, klength, knum, kt, ku, kv);
+		if (nk != ((n < 4) ? n : 4)) bad_k++;
+		else
+		{
+			for (j = 0; j < nk; j++)
+				if (!(fabs(klength[j] - tlength[j]) <= RS_CHECK_TOLERANCE_LENGTH * (set.radcurv + tlength[j]))) break;
+			if (j < nk) bad_k++;
+		}
+	}
+	report("reed_shepp_topk first", isa, bad_first, RS_CHECK_QUERIES);
+	report("reed_shepp_topk sorted", isa, bad_sorted, RS_CHECK_QUERIES);
+	report("reed_shepp_topk goal", isa, bad_goal, RS_CHECK_QUERIES);
+	report("reed_shepp_topk k = 4", isa, bad_k, RS_CHECK_QUERIES);
+}
+
+
+/***********************************************************/
+/*
+reed_shepp_filtered with RS_MASK_ALL gives the curve of reed_shepp, and
+with the masks of rs_mask_no_reverse, rs_mask_csc and rs_mask_max_cusps
+the shortest of the 48 curves of reed_shepp_topk that are driven forward
+only, made of an arc, a line and an arc, or have at most 0, 1 or 2 cusps.
+These properties are read on the rs_path of each curve.
+*/
+static void check_filtered(const char* isa)
+{
+	unsigned long long masks[5], expected[5];
+	double tlength[48], tt[48], tu[48], tv[48];
+	double l, best, tf, uf, vf;
+	int tnum[48];
+	rs_path path;
+	int num, s, m, i, j, n, nf, cusps, forward, bad_all, bad_masks, bad_filtered;
+
+	masks[0] = rs_mask_no_reverse();
+	masks[1] = rs_mask_csc();
+	masks[2] = rs_mask_max_cusps(0);
+	masks[3] = rs_mask_max_cusps(1);
+	masks[4] = rs_mask_max_cusps(2);
+
+	memset(expected, 0, sizeof(expected));
+	for (num = 1; num <= 48; num++)
+	{
+		rs_path_from_word(&path, num, 1, 1, 1, 0, 0, 0);
+		cusps = 0;
+		forward = 1;
+		for (s = 0; s < path.nsegments; s++)
+		{
+			if (path.segments[s].direction != 1) forward = 0;
+			if ((s > 0) && (path.segments[s].direction != path.segments[s - 1].direction)) cusps++;
+		}
+		if (forward) expected[0] |= RS_MASK_WORD(num);
+		if ((path.nsegments == 3) && (path.segments[0].type != RS_STRAIGHT) && (path.segments[1].type == RS_STRAIGHT)
+			&& (path.segments[2].type != RS_STRAIGHT))
+			expected[1] |= RS_MASK_WORD(num);
+		for (m = 0; m <= 2; m++)
+			if (cusps <= m) expected[2 + m] |= RS_MASK_WORD(num);
+	}
+	bad_masks = 0;
+	for (m = 0; m < 5; m++)
+		if (masks[m] != expected[m]) bad_masks++;
+	report("rs_mask_*", isa, bad_masks, 5);
+
+	bad_all = bad_filtered = 0;
+	for (i = 0; i < RS_CHECK_QUERIES; i++)
+	{
+		l = reed_shepp_filtered(set.x1[i], set.y1[i], set.t1[i], set.x2[i], set.y2[i], set.t2[i], RS_MASK_ALL, &nf, &tf, &uf, &vf);
+		if (!same_curve(i, l, nf, tf, uf, vf, RS_CHECK_TOLERANCE_LENGTH)) bad_all++;
+
+		n = reed_shepp_topk(set.x1[i], set.y1[i], set.t1[i], set.x2[i], set.y2[i], set.t2[i], 48, tlength, tnum, tt, tu, tv);
+		for (m = 0; m < 5; m++)
+		{
+			best = -1;
+			for (j = 0; j < n; j++)
+				if (expected[m] & RS_MASK_WORD(tnum[j]))
+				{
+					best = tlength[j];
+					break;
+				}
+
+			l = reed_shepp_filtered(set.x1[i], set.y1[i], set.t1[i], set.x2[i], set.y2[i], set.t2[i], masks[m], &nf, &tf, &uf, &vf);
+			if (best < 0)
+			{
+				if ((l != -1) || (nf != 0)) bad_filtered++;
+			}
+			else if (!(fabs(l - best) <= RS_CHECK_TOLERANCE_LENGTH * (set.radcurv + best)) || !(expected[m] & RS_MASK_WORD(nf))
+				|| !ends_at_goal(i, l, nf, tf, uf, vf))
+				bad_filtered++;
+		}
+	}
+	report("reed_shepp_filtered all", isa, bad_all, RS_CHECK_QUERIES);
+	report("reed_shepp_filtered masks", isa, bad_filtered, 5 * RS_CHECK_QUERIES);
+}
+
+
+/***********************************************************/
+/*
+Cost of the path for the weights of cost, recomputed from its segments:
+the reference of reed_shepp_weighted is the smallest one among the 48
+curves of reed_shepp_topk.
+*/
+static double path_cost(const rs_path* path, const rs_cost* cost)
+{
+	const rs_path_segment* seg;
+	double c;
+	int i, last;
+
+	c = 0;
+	last = 0;
+	for (i = 0; i < path->nsegments; i++)
+	{
+		seg = &path->segments[i];
+		if (seg->length < 1e-12 * path->radcurv) continue;
+		if (seg->type == RS_STRAIGHT) c += seg->length * ((seg->direction == 1) ? cost->forward_straight : cost->reverse_straight);
+		else c += seg->length * ((seg->direction == 1) ? cost->forward_arc : cost->reverse_arc);
+		if ((last != 0) && (seg->direction != last)) c += cost->cusp;
+		last = seg->direction;
+	}
+	return(c);
+}
+
+
+/***********************************************************/
+/*
+reed_shepp_weighted with unit weights gives the curve of reed_shepp, and
+with other weights the cheapest of the 48 curves, its cost recomputed
+from the segments of its rs_path.
+*/
+static void check_weighted(const char* isa)
+{
+	const rs_cost unit = { 1, 1, 1, 1, 0 };
+	rs_cost costs[3] = { { 1, 2, 1, 2, 0 }, { 1, 1, 1, 1, 3 }, { 1, 1.5, 0.8, 3, 0.5 } };
+	double tlength[48], tt[48], tu[48], tv[48];
+	double c, best, tw, uw, vw;
+	int tnum[48];
+	rs_path path;
+	int i, j, m, n, nw, bad_unit, bad_cost;
+
+	/* the cusp in units of length */
+	costs[1].cusp *= set.radcurv;
+	costs[2].cusp *= set.radcurv;
+
+	bad_unit = bad_cost = 0;
+	for (i = 0; i < RS_CHECK_QUERIES; i++)
+	{
+		c = reed_shepp_weighted(set.x1[i], set.y1[i], set.t1[i], set.x2[i], set.y2[i], set.t2[i], &unit, &nw, &tw, &uw, &vw);
+		if (!same_curve(i, c, nw, tw, uw, vw, RS_CHECK_TOLERANCE)) bad_unit++;
+
+		n = reed_shepp_topk(set.x1[i], set.y1[i], set.t1[i], set.x2[i], set.y2[i], set.t2[i], 48, tlength, tnum, tt, tu, tv);
+		for (m = 0; m < 3; m++)
+		{
+			best = HUGE_VAL;
+			for (j = 0; j < n; j++)
+			{
+				rs_path_from_word(&path, tnum[j], tt[j], tu[j], tv[j], set.x1[i], set.y1[i], set.t1[i]);
+				c = path_cost(&path, &costs[m]);
+				if (c < best) best = c;
+			}
+
+			c = reed_shepp_weighted(set.x1[i], set.y1[i], set.t1[i], set.x2[i], set.y2[i], set.t2[i], &costs[m], &nw, &tw, &uw, &vw);
+			if (!(fabs(c - best) <= RS_CHECK_TOLERANCE * (set.radcurv + best))
+				|| !rs_path_from_word(&path, nw, tw, uw, vw, set.x1[i], set.y1[i], set.t1[i])
+				|| !ends_at_goal(i, rs_path_length(&path), nw, tw, uw, vw)
+				|| !(fabs(path_cost(&path, &costs[m]) - c) <= RS_CHECK_TOLERANCE * (set.radcurv + c)))
+				bad_cost++;
+		}
+	}
+	report("reed_shepp_weighted unit", isa, bad_unit, RS_CHECK_QUERIES);
+	report("reed_shepp_weighted costs", isa, bad_cost, 3 * RS_CHECK_QUERIES);
+}
+
+
+/***********************************************************/
+/*
+The canonical scan gives the curves of the scalar scan, bit for bit.
+*/
+static void check_canonical(const char* isa)
+{
+	int i, bad;
+
+	change_scan(RS_SCAN_CANONICAL);
+	reed_shepp_batch(RS_CHECK_QUERIES, set.x1, set.y1, set.t1, set.x2, set.y2, set.t2, length, num, t, u, v);
+	change_scan(RS_SCAN_FULL);
+
+	bad = 0;
+	for (i = 0; i < RS_CHECK_QUERIES; i++)
+		if ((length[i] != set.length[i]) || (num[i] != set.num[i]) || (t[i] != set.t[i]) || (u[i] != set.u[i]) || (v[i] != set.v[i])) bad++;
+	report("RS_SCAN_CANONICAL", isa, bad, RS_CHECK_QUERIES);
+}
+
+
+/***********************************************************/
+static void check_float(const char* isa)
+{
+	float l, tf, uf, vf;
+	int i, n, bad;
+
+	bad = 0;
+	for (i = 0; i < RS_CHECK_QUERIES; i++)
+	{
+		l = reed_shepp_f(set.fx1[i], set.fy1[i], set.ft1[i], set.fx2[i], set.fy2[i], set.ft2[i], &n, &tf, &uf, &vf);
+		if (!(fabs(l - set.flength[i]) <= RS_CHECK_TOLERANCE_F * (set.radcurv + set.flength[i])) || (n < 1) || (n > 48)) bad++;
+	}
+	report("reed_shepp_f", isa, bad, RS_CHECK_QUERIES);
+
+	reed_shepp_batch_f(RS_CHECK_QUERIES, set.fx1, set.fy1, set.ft1, set.fx2, set.fy2, set.ft2, flength, num, ft, fu, fv);
+	bad = 0;
+	for (i = 0; i < RS_CHECK_QUERIES; i++)
+		if (!(fabs(flength[i] - set.flength[i]) <= RS_CHECK_TOLERANCE_F * (set.radcurv + set.flength[i])) || (num[i] < 1) || (num[i] > 48)) bad++;
+	report("reed_shepp_batch_f", isa, bad, RS_CHECK_QUERIES);
+}
+
+
+/***********************************************************/
+/*
+reed_shepp_mixed may keep a curve slightly longer than the shortest one,
+but the curve it gives is computed in double and goes to the goal.
+*/
+static int mixed_curve(int i, double l, int num, double t, double u, double v)
+{
+	double margin, x, y, theta;
+
+	margin = RS_CHECK_TOLERANCE * (set.radcurv + set.length[i]);
+	if (!(l >= set.length[i] - margin) || !(l <= set.length[i] + RS_CHECK_TOLERANCE_MIXED * (set.radcurv + set.length[i]))) return(0);
+	if (!rs_pose_at(num, t, u, v, set.x1[i], set.y1[i], set.t1[i], l, &x, &y, &theta)) return(0);
+	return((fabs(x - set.x2[i]) <= margin) && (fabs(y - set.y2[i]) <= margin)
+		&& (fabs(remainder(theta - set.t2[i], 2 * PI)) <= margin / set.radcurv));
+}
+
+
+/***********************************************************/
+static void check_mixed(const char* isa)
+{
+	double l, tm, um, vm;
+	int i, n, bad;
+
+	bad = 0;
+	for (i = 0; i < RS_CHECK_QUERIES; i++)
+	{
+		l = reed_shepp_mixed(set.x1[i], set.y1[i], set.t1[i], set.x2[i], set.y2[i], set.t2[i], &n, &tm, &um, &vm);
+		if (!mixed_curve(i, l, n, tm, um, vm)) bad++;
+	}
+	report("reed_shepp_mixed", isa, bad, RS_CHECK_QUERIES);
+
+	reed_shepp_batch_mixed(RS_CHECK_QUERIES, set.x1, set.y1, set.t1, set.x2, set.y2, set.t2, length, num, t, u, v);
+	bad = 0;
+	for (i = 0; i < RS_CHECK_QUERIES; i++)
+		if (!mixed_curve(i, length[i], num[i], t[i], u[i], v[i])) bad++;
+	report("reed_shepp_batch_mixed", isa, bad, RS_CHECK_QUERIES);
+}
+
+
+/***********************************************************/
+/*
+A query repeated at once hits the cache, and both give back what
+reed_shepp gave.
+*/
+static void check_cache(const char* isa)
+{
+	rs_cache* cache;
+	unsigned long long hits, misses;
+	double l, tc, uc, vc;
+	int i, pass, n, bad;
+
+	cache = rs_cache_create(2 * RS_CHECK_QUERIES, 0, 0);
+	if (cache == NULL)
+	{
+		report("reed_shepp_cached", isa, RS_CHECK_QUERIES, RS_CHECK_QUERIES);
+		return;
+	}
+
+	bad = 0;
+	for (i = 0; i < RS_CHECK_QUERIES; i++)
+		for (pass = 0; pass < 2; pass++)
+		{
+			l = reed_shepp_cached(cache, set.x1[i], set.y1[i], set.t1[i], set.x2[i], set.y2[i], set.t2[i], &n, &tc, &uc, &vc);
+			if (!same_curve(i, l, n, tc, uc, vc, RS_CHECK_TOLERANCE)) bad++;
+		}
+	rs_cache_stats(cache, &hits, &misses);
+	if (hits + misses != 2 * RS_CHECK_QUERIES) bad++;
+	if (hits < RS_CHECK_QUERIES) bad++;
+	rs_cache_destroy(cache);
+	report("reed_shepp_cached", isa, bad, 2 * RS_CHECK_QUERIES);
+}
+
+
+/***********************************************************/
+/*
+Last call of the progress of reed_shepp_matrix.
+*/
+typedef struct
+{
+	long long done, total;
+	int calls;
+} rs_check_progress;
+
+static void progress_last(void* user, long long done, long long total)
+{
+	rs_check_progress* progress;
+
+	progress = (rs_check_progress*)user;
+	progress->done = done;
+	progress->total = total;
+	progress->calls++;
+}
+
+
+/***********************************************************/
+/*
+reed_shepp_matrix from the starts of the first RS_CHECK_ROWS queries to
+the goals of the first RS_CHECK_COLUMNS, for each band, on one thread and
+on several: the lengths inside the band are the ones of
+reed_shepp_length, the ones outside are left as they were, and the last
+call of progress is total / total.
+*/
+static void check_matrix(const char* isa)
+{
+	static double matrix[RS_CHECK_ROWS * RS_CHECK_COLUMNS], reference[RS_CHECK_ROWS * RS_CHECK_COLUMNS];
+	const int bands[3] = { RS_MATRIX_FULL, RS_MATRIX_UPPER, RS_MATRIX_LOWER };
+	const int nthreads[2] = { 1, 4 };
+	rs_check_progress progress;
+	int b, p, i, j, inside, bad, bad_progress;
+
+	for (i = 0; i < RS_CHECK_ROWS; i++)
+		for (j = 0; j < RS_CHECK_COLUMNS; j++)
+			reference[i * RS_CHECK_COLUMNS + j] = reed_shepp_length(set.x1[i], set.y1[i], set.t1[i], set.x2[j], set.y2[j], set.t2[j]);
+
+	bad = bad_progress = 0;
+	for (b = 0; b < 3; b++)
+		for (p = 0; p < 2; p++)
+		{
+			for (i = 0; i < RS_CHECK_ROWS * RS_CHECK_COLUMNS; i++) matrix[i] = -1;
+			progress.done = progress.total = -1;
+			progress.calls = 0;
+			if (!reed_shepp_matrix(RS_CHECK_ROWS, set.x1, set.y1, set.t1, RS_CHECK_COLUMNS, set.x2, set.y2, set.t2,
+				bands[b], nthreads[p], matrix, progress_last, &progress))
+			{
+				bad += RS_CHECK_ROWS * RS_CHECK_COLUMNS;
+				bad_progress++;
+				continue;
+			}
+
+			for (i = 0; i < RS_CHECK_ROWS; i++)
+				for (j = 0; j < RS_CHECK_COLUMNS; j++)
+				{
+					inside = (bands[b] == RS_MATRIX_FULL) || ((bands[b] == RS_MATRIX_UPPER) && (j >= i))
+						|| ((bands[b] == RS_MATRIX_LOWER) && (j <= i));
+					if (inside ? !(fabs(matrix[i * RS_CHECK_COLUMNS + j] - reference[i * RS_CHECK_COLUMNS + j])
+						<= RS_CHECK_TOLERANCE * (set.radcurv + reference[i * RS_CHECK_COLUMNS + j]))
+						: (matrix[i * RS_CHECK_COLUMNS + j] != -1))
+						bad++;
+				}
+			if ((progress.calls == 0) || (progress.total <= 0) || (progress.done != progress.total)) bad_progress++;
+		}
+
+	report("reed_shepp_matrix", isa, bad, 6 * RS_CHECK_ROWS * RS_CHECK_COLUMNS);
+	report("reed_shepp_matrix progress", isa, bad_progress, 6);
+}
+
+
+/***********************************************************/
+/*
+Inside the table, at its points, the interpolated length is the one of
+reed_shepp rounded to float. Outside, it is the exact length.
+*/
+static void check_table(const char* isa)
+{
+	const char* path = "ReedAndShepp_check.table";
+	const int nx = 33, ny = 33, nphi = 48;
+	const double xmax = 8, ymax = 8;
+	rs_table* table;
+	double x, y, phi, l, exact, tr, ur, vr;
+	int i, j, k, n, bad, count;
+
+	if (!rs_table_build(path, nx, ny, nphi, xmax, ymax) || ((table = rs_table_open(path)) == NULL))
+	{
+		remove(path);
+		report("reed_shepp_table_length", isa, 1, 1);
+		return;
+	}
+
+	bad = 0;
+	count = 0;
+	for (i = 0; i < nx; i += 4)
+		for (j = 0; j < ny; j += 4)
+			for (k = 0; k < nphi; k++)
+			{
+				/* the upper edges are outside, where the exact length is used */
+				x = set.radcurv * ((i < nx - 1) ? i * xmax / (nx - 1) : xmax * (1 - 1e-15));
+				y = set.radcurv * ((j < ny - 1) ? j * ymax / (ny - 1) : ymax * (1 - 1e-15));
+				phi = -MPI + k * MPIMUL2 / nphi;
+				l = reed_shepp_table_length(table, 0, 0, 0, x, y, phi);
+				exact = reed_shepp(0, 0, 0, x, y, phi, &n, &tr, &ur, &vr);
+				if (!(fabs(l - exact) <= 1e-5 * (set.radcurv + exact))) bad++;
+				count++;
+			}
+
+	for (i = 0; i < RS_CHECK_QUERIES; i++)
+	{
+		x = set.x2[i] - set.x1[i];
+		y = set.y2[i] - set.y1[i];
+		if (sqrt(x * x + y * y) < set.radcurv * (xmax + ymax)) continue;
+		l = reed_shepp_table_length(table, set.x1[i], set.y1[i], set.t1[i], set.x2[i], set.y2[i], set.t2[i]);
+		if (!(fabs(l - set.length[i]) <= RS_CHECK_TOLERANCE * (set.radcurv + set.length[i]))) bad++;
+		count++;
+	}
+
+	rs_table_close(table);
+	remove(path);
+	report("reed_shepp_table_length", isa, bad, count);
+}
+
+
+/***********************************************************/
+/*
+constRS_count, constRS_bounded and the cursor give the points of constRS
+for the curves of the reference.
+*/
+static void check_paths(const char* isa)
+{
+	rs_cursor cursor;
+	double x, y, theta;
+	int i, k, n, half, truncated, bad_count, bad_bounded, bad_cursor;
+
+	bad_count = bad_bounded = bad_cursor = 0;
+	for (i = 0; i < RS_CHECK_QUERIES; i += 4)
+	{
+		n = constRS(set.num[i], set.t[i], set.u[i], set.v[i], set.x1[i], set.y1[i], set.t1[i], RS_CHECK_DELTA, pathx, pathy, patht);
+
+		if (constRS_count(set.num[i], set.t[i], set.u[i], set.v[i], set.x1[i], set.y1[i], set.t1[i], RS_CHECK_DELTA) != n) bad_count++;
+
+		half = n / 2;
+		if ((constRS_bounded(set.num[i], set.t[i], set.u[i], set.v[i], set.x1[i], set.y1[i], set.t1[i], RS_CHECK_DELTA,
+			half, boundedx, boundedy, boundedt, &truncated) != half) || (truncated != (half < n))
+			|| (memcmp(boundedx, pathx, half * sizeof(double)) != 0) || (memcmp(boundedy, pathy, half * sizeof(double)) != 0)
+			|| (memcmp(boundedt, patht, half * sizeof(double)) != 0))
+			bad_bounded++;
+
+		rs_cursor_init(&cursor, set.num[i], set.t[i], set.u[i], set.v[i], set.x1[i], set.y1[i], set.t1[i], RS_CHECK_DELTA);
+		for (k = 0; rs_cursor_next(&cursor, &x, &y, &theta); k++)
+			if ((k >= n) || (x != pathx[k]) || (y != pathy[k]) || (theta != patht[k])) break;
+		if ((k != n) || rs_cursor_next(&cursor, &x, &y, &theta)) bad_cursor++;
+	}
+
+	report("constRS_count", isa, bad_count, RS_CHECK_QUERIES / 4);
+	report("constRS_bounded", isa, bad_bounded, RS_CHECK_QUERIES / 4);
+	report("rs_cursor", isa, bad_cursor, RS_CHECK_QUERIES / 4);
+}
+
+
+/***********************************************************/
+/*
+Returns 1 when the poses are within margin in position, and margin /
+radcurv in heading.
+*/
+static int same_pose(double x1, double y1, double t1, double x2, double y2, double t2, double margin)
+{
+	return((fabs(x1 - x2) <= margin) && (fabs(y1 - y2) <= margin)
+		&& (fabs(remainder(t1 - t2, 2 * PI)) <= margin / set.radcurv));
+}
+
+
+/***********************************************************/
+/*
+rs_path_reverse, rs_path_split, rs_path_concat and rs_path_sample on the
+paths of the curves of the reference: the reversed path passes at the
+length L - s where the path passes at s, the two parts of a split path
+concatenated give it back, the samples start at the start and end at the
+goal, and a step that is not positive gives no sample.
+*/
+static void check_path_edit(const char* isa)
+{
+	const double steps[4] = { 0, -1, NAN, 1e-300 };
+	rs_path path, reversed, first, second, joined;
+	double l, s, cut, margin, step, x, y, theta, xr, yr, tr;
+	int i, k, n, bad_reverse, bad_split, bad_sample;
+
+	bad_reverse = bad_split = bad_sample = 0;
+	for (i = 0; i < RS_CHECK_QUERIES; i += 4)
+	{
+		rs_path_from_word(&path, set.num[i], set.t[i], set.u[i], set.v[i], set.x1[i], set.y1[i], set.t1[i]);
+		l = rs_path_length(&path);
+		margin = RS_CHECK_TOLERANCE * (set.radcurv + l);
+
+		rs_path_reverse(&path, &reversed);
+		if (!(fabs(rs_path_length(&reversed) - l) <= margin)) bad_reverse++;
+		else
+		{
+			for (k = 0; k <= 10; k++)
+			{
+				s = l * k / 10;
+				rs_path_eval(&path, s, &x, &y, &theta);
+				rs_path_eval(&reversed, l - s, &xr, &yr, &tr);
+				if (!same_pose(x, y, theta, xr, yr, tr, margin)) break;
+			}
+			if (k <= 10) bad_reverse++;
+		}
+
+		/* inside, at the ends and past them */
+		cut = (i % 16 == 0) ? 0 : (i % 16 == 4) ? l : (i % 16 == 8) ? l + 1 : uniform(0, l);
+		rs_path_split(&path, cut, &first, &second);
+		rs_path_eval(&path, cut, &x, &y, &theta);
+		if (!rs_path_concat(&first, &second, &joined) || !(fabs(rs_path_length(&first) - fmin(cut, l)) <= margin)
+			|| !(fabs(rs_path_length(&joined) - l) <= margin) || !same_pose(second.x, second.y, second.theta, x, y, theta, margin))
+			bad_split++;
+		else
+		{
+			for (k = 0; k <= 10; k++)
+			{
+				s = l * k / 10;
+				rs_path_eval(&path, s, &x, &y, &theta);
+				rs_path_eval(&joined, s, &xr, &yr, &tr);
+				if (!same_pose(x, y, theta, xr, yr, tr, margin)) break;
+			}
+			if (k <= 10) bad_split++;
+		}
+
+		step = set.radcurv * uniform(0.01, 1);
+		n = rs_path_sample(&path, step, RS_CHECK_POINTS, pathx, pathy, patht);
+		if ((n < 1) || (n > RS_CHECK_POINTS) || !same_pose(pathx[0], pathy[0], patht[0], set.x1[i], set.y1[i], set.t1[i], margin)
+			|| !same_pose(pathx[n - 1], pathy[n - 1], patht[n - 1], set.x2[i], set.y2[i], set.t2[i],
+				RS_CHECK_TOLERANCE_GOAL * (set.radcurv + l)))
+			bad_sample++;
+		else
+		{
+			for (k = 0; k < n - 1; k++)
+			{
+				rs_path_eval(&path, k * step, &x, &y, &theta);
+				if (!same_pose(pathx[k], pathy[k], patht[k], x, y, theta, margin)) break;
+			}
+			if (k < n - 1) bad_sample++;
+		}
+		if (rs_path_sample(&path, steps[i / 4 % 4], RS_CHECK_POINTS, pathx, pathy, patht) != 0) bad_sample++;
+	}
+
+	report("rs_path_reverse", isa, bad_reverse, RS_CHECK_QUERIES / 4);
+	report("rs_path_split", isa, bad_split, RS_CHECK_QUERIES / 4);
+	report("rs_path_sample", isa, bad_sample, RS_CHECK_QUERIES / 4);
+}
+
+
+/***********************************************************/
+/*
+Returns 1 when the footprint at (x,y,theta) is inside the grid and does
+not overlap an occupied cell, the circles taken as they are.
+*/
+static int footprint_free(const rs_grid* grid, const rs_circle* footprint, int ncircles, double x, double y, double theta)
+{
+	double cx, cy, dx, dy, r;
+	int k, i, j, i0, i1, j0, j1;
+
+	for (k = 0; k < ncircles; k++)
+	{
+		cx = x + footprint[k].x * cos(theta) - footprint[k].y * sin(theta) - grid->originx;
+		cy = y + footprint[k].x * sin(theta) + footprint[k].y * cos(theta) - grid->originy;
+		r = footprint[k].radius;
+		if ((cx - r < 0) || (cy - r < 0) || (cx + r >= grid->width * grid->resolution) || (cy + r >= grid->height * grid->resolution))
+			return(0);
+
+		i0 = (int)((cx - r) / grid->resolution);
+		i1 = (int)((cx + r) / grid->resolution);
+		j0 = (int)((cy - r) / grid->resolution);
+		j1 = (int)((cy + r) / grid->resolution);
+		for (j = j0; j <= j1; j++)
+			for (i = i0; i <= i1; i++)
+			{
+				if (!grid->occupancy[j * grid->width + i]) continue;
+				dx = fmax(0, fmax(i * grid->resolution - cx, cx - (i + 1) * grid->resolution));
+				dy = fmax(0, fmax(j * grid->resolution - cy, cy - (j + 1) * grid->resolution));
+				if (dx * dx + dy * dy <= r * r) return(0);
+			}
+	}
+	return(1);
+}
+
+
+/***********************************************************/
+/*
+rs_path_collision_free may report a collision that is not there, but not
+miss one: on random paths through random bitmaps, and the distance fields
+computed from them, a collision found by poses every 1 / 200 of a cell
+must be found too, the length checked free not going past it.
+*/
+static void check_collision(const char* isa)
+{
+	static unsigned char occupancy[RS_CHECK_GRID * RS_CHECK_GRID];
+	static float distance[RS_CHECK_GRID * RS_CHECK_GRID];
+	const rs_circle footprint[3] = { { -0.3, 0, 0.35 }, { 0.3, 0, 0.35 }, { 0.9, 0, 0.3 } };
+	rs_grid grid;
+	rs_path path;
+	double length, s, step, x, y, theta, collision, free_length, dx, dy, d;
+	int p, mode, i, j, a, b, free, bad, collide;
+
+	grid.width = RS_CHECK_GRID;
+	grid.height = RS_CHECK_GRID;
+	grid.resolution = 0.25;
+	grid.originx = -8;
+	grid.originy = -8;
+	grid.occupancy = occupancy;
+
+	bad = collide = 0;
+	for (p = 0; p < RS_CHECK_PATHS; p++)
+	{
+		/* a new bitmap every 100 paths, with 1 % of the cells occupied */
+		if (p % 100 == 0)
+		{
+			for (i = 0; i < RS_CHECK_GRID * RS_CHECK_GRID; i++)
+				occupancy[i] = (rand() % 100 == 0);
+			for (j = 0; j < RS_CHECK_GRID; j++)
+				for (i = 0; i < RS_CHECK_GRID; i++)
+				{
+					distance[j * RS_CHECK_GRID + i] = HUGE_VAL;
+					for (b = 0; b < RS_CHECK_GRID; b++)
+						for (a = 0; a < RS_CHECK_GRID; a++)
+						{
+							if (!occupancy[b * RS_CHECK_GRID + a]) continue;
+							dx = fmax(0, fabs(a - i) - 0.5) * grid.resolution;
+							dy = fmax(0, fabs(b - j) - 0.5) * grid.resolution;
+							d = sqrt(dx * dx + dy * dy);
+							if (d < distance[j * RS_CHECK_GRID + i]) distance[j * RS_CHECK_GRID + i] = (float)d;
+						}
+				}
+		}
+
+		reed_shepp_path(uniform(-5, 5), uniform(-5, 5), uniform(-PI, PI), uniform(-5, 5), uniform(-5, 5), uniform(-PI, PI), &path);
+		length = rs_path_length(&path);
+
+		/* the first collision of the dense reference */
+		step = grid.resolution / 200;
+		collision = -1;
+		for (s = 0; s <= length + step; s += step)
+		{
+			rs_path_eval(&path, s, &x, &y, &theta);
+			if (!footprint_free(&grid, footprint, 3, x, y, theta))
+			{
+				collision = (s < length) ? s : length;
+				break;
+			}
+		}
+		if (collision >= 0) collide++;
+
+		for (mode = 0; mode < 2; mode++)
+		{
+			grid.distance = (mode == 0) ? NULL : distance;
+			free = rs_path_collision_free(&path, footprint, 3, &grid, &free_length);
+			if ((collision >= 0) && (free || (free_length > collision))) bad++;
+		}
+	}
+	printf("%d / %d paths in collision\n", collide, RS_CHECK_PATHS);
+	report("rs_path_collision_free", isa, bad, 2 * RS_CHECK_PATHS);
+}
+
+
+/***********************************************************/
+static int compare_double(const void* a, const void* b)
+{
+	double x = *(const double*)a, y = *(const double*)b;
+	return((x > y) - (x < y));
+}
+
+
+/***********************************************************/
+static int compare_int(const void* a, const void* b)
+{
+	return(*(const int*)a - *(const int*)b);
+}
+
+
+/***********************************************************/
+/*
+rs_index_knn and rs_index_radius give the configurations a scan of all
+of them with reed_shepp_length gives, with cells much smaller and much
+larger than the spacing of the configurations, and far outliers that
+the search reaches only after many empty rings.
+*/
+static void check_index(const char* isa)
+{
+	static double px[RS_CHECK_INDEX], py[RS_CHECK_INDEX], pt[RS_CHECK_INDEX], all[RS_CHECK_INDEX];
+	static int ids[RS_CHECK_INDEX], expected[RS_CHECK_INDEX];
+	static double lengths[RS_CHECK_INDEX];
+	const double cells[3] = { 0.05, 1, 50 };
+	const int ks[3] = { 1, 5, 50 };
+	const double radii[3] = { 0.5, 3, 20 };
+	rs_index* index;
+	double qx, qy, qt, sorted[RS_CHECK_INDEX];
+	int c, i, j, q, n, m, total, bad_insert, bad_knn, bad_radius;
+
+	/* about 0.5 apart in [-10,10] x [-10,10], and 20 outliers 1000 away */
+	for (i = 0; i < RS_CHECK_INDEX; i++)
+	{
+		if (i < RS_CHECK_INDEX - 20)
+		{
+			px[i] = uniform(-10, 10);
+			py[i] = uniform(-10, 10);
+		}
+		else
+		{
+			px[i] = 1000 * cos(i);
+			py[i] = 1000 * sin(i);
+		}
+		pt[i] = uniform(-PI, PI);
+	}
+
+	bad_insert = bad_knn = bad_radius = 0;
+	for (c = 0; c < 3; c++)
+	{
+		index = rs_index_create(cells[c]);
+		if (index == NULL)
+		{
+			bad_insert++;
+			continue;
+		}
+		for (i = 0; i < RS_CHECK_INDEX; i++)
+			if (rs_index_insert(index, px[i], py[i], pt[i]) != i) bad_insert++;
+		if ((rs_index_insert(index, NAN, 0, 0) != -1) || (rs_index_insert(index, 0, NAN, 0) != -1)
+			|| (rs_index_insert(index, 1e10 * cells[c], 0, 0) != -1) || (rs_index_size(index) != RS_CHECK_INDEX))
+			bad_insert++;
+
+		for (q = 0; q < 100; q++)
+		{
+			/* near the cluster, in the empty space around it, and near an outlier */
+			if (q % 4 == 3)
+			{
+				qx = 1000 * cos(RS_CHECK_INDEX - 1 - q % 20) + uniform(-30, 30);
+				qy = 1000 * sin(RS_CHECK_INDEX - 1 - q % 20) + uniform(-30, 30);
+			}
+			else
+			{
+				qx = uniform(-10, 10) * ((q % 4 == 2) ? 20 : 1);
+				qy = uniform(-10, 10) * ((q % 4 == 2) ? 20 : 1);
+			}
+			qt = uniform(-PI, PI);
+
+			for (i = 0; i < RS_CHECK_INDEX; i++)
+			{
+				all[i] = reed_shepp_length(qx, qy, qt, px[i], py[i], pt[i]);
+				sorted[i] = all[i];
+			}
+			qsort(sorted, RS_CHECK_INDEX, sizeof(double), compare_double);
+
+			for (j = 0; j < 3; j++)
+			{
+				n = rs_index_knn(index, qx, qy, qt, ks[j], ids, lengths);
+				if (n != ks[j]) bad_knn++;
+				else
+				{
+					for (i = 0; i < n; i++)
+						if ((lengths[i] != sorted[i]) || (lengths[i] != all[ids[i]])) break;
+					if (i < n) bad_knn++;
+				}
+
+				m = 0;
+				for (i = 0; i < RS_CHECK_INDEX; i++)
+					if (all[i] <= radii[j]) expected[m++] = i;
+				total = rs_index_radius(index, qx, qy, qt, radii[j], RS_CHECK_INDEX, ids, lengths);
+				qsort(ids, (total < RS_CHECK_INDEX) ? total : RS_CHECK_INDEX, sizeof(int), compare_int);
+				if ((total != m) || (memcmp(ids, expected, m * sizeof(int)) != 0)) bad_radius++;
+				if ((m > 1) && (rs_index_radius(index, qx, qy, qt, radii[j], m / 2, ids, lengths) != m)) bad_radius++;
+			}
+		}
+		rs_index_destroy(index);
+	}
+	report("rs_index_insert", isa, bad_insert, 3 * (RS_CHECK_INDEX + 1));
+	report("rs_index_knn", isa, bad_knn, 900);
+	report("rs_index_radius", isa, bad_radius, 900);
+}
+
+
+/***********************************************************/
+int main(void)
+{
+	static const char* isas[4] = { "scalar", "sse42", "avx2", "avx512" };
+	const double radii[2] = { 1.0, 2.5 };
+	double tr, ur, vr;
+	int r, i, k, n;
+
+	srand(1);
+	for (r = 0; r < 2; r++)
+	{
+		change_radcurv(radii[r]);
+		make_set(radii[r]);
+		printf("radius %g\n", radii[r]);
+
+		rs_select_isa("scalar");
+		for (i = 0; i < RS_CHECK_QUERIES; i++)
+		{
+			set.length[i] = reed_shepp(set.x1[i], set.y1[i], set.t1[i], set.x2[i], set.y2[i], set.t2[i],
+				&set.num[i], &set.t[i], &set.u[i], &set.v[i]);
+			set.flength[i] = reed_shepp(set.fx1[i], set.fy1[i], set.ft1[i], set.fx2[i], set.fy2[i], set.ft2[i], &n, &tr, &ur, &vr);
+		}
+
+		check_length("scalar");
+		check_topk("scalar");
+		check_filtered("scalar");
+		check_weighted("scalar");
+		check_canonical("scalar");
+		check_table("scalar");
+		check_paths("scalar");
+		check_path_edit("scalar");
+		check_collision("scalar");
+		check_index("scalar");
+
+		for (k = 0; k < 4; k++)
+		{
+			rs_select_isa(isas[k]);
+			if (strcmp(rs_isa(), isas[k]) != 0) continue;
+			check_reed_shepp(isas[k]);
+			check_float(isas[k]);
+			check_mixed(isas[k]);
+			check_cache(isas[k]);
+			check_matrix(isas[k]);
+		}
+	}
+
+	rs_select_isa(NULL);
+	printf("%s\n", (failures == 0) ? "all checks passed" : "some checks failed");
+	return((failures == 0) ? 0 : 1);
+}
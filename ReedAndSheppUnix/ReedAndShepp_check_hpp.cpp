@@ -0,0 +1,97 @@
+// ReedAndShepp_check_hpp.cpp : compares ReedAndShepp.hpp with reed_shepp.
+//
+// Built and run by "make check", with RS_ISA=scalar so that reed_shepp uses
+// the scalar scan. ReedsShepp<double> gives the results of reed_shepp bit for
+// bit, with the radius given at run time or fixed at compile time, and
+// ReedsShepp<float> its lengths within RS_CHECK_TOLERANCE_F. Exits with 1
+// when any query disagrees.
+
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <ratio>
+
+#include "ReedAndShepp.h"
+#include "ReedAndShepp.hpp"
+
+#define RS_CHECK_QUERIES 20000
+/* lengths in single precision, see ReedAndShepp.hpp */
+#define RS_CHECK_TOLERANCE_F 1e-3
+
+#define PI 3.14159265358979323846
+
+static int failures;
+
+
+/***********************************************************/
+static double uniform(double a, double b)
+{
+	return(a + (b - a) * rand() / (double)RAND_MAX);
+}
+
+
+/***********************************************************/
+static void report(const char* name, int bad, int n)
+{
+	printf("%-36s %6d / %d mismatches\n", name, bad, n);
+	if (bad != 0) failures++;
+}
+
+
+/***********************************************************/
+/*
+Runs the solvers on the same queries as reed_shepp with the radius
+radcurv, fixed being the solver for this radius fixed at compile time.
+*/
+template <typename Fixed>
+static void check(double radcurv, const Fixed& fixed, const char* name)
+{
+	ReedsShepp<double> runtime(radcurv);
+	ReedsShepp<float> single((float)radcurv);
+	double x1, y1, t1, x2, y2, t2, scale, l, tr, ur, vr, lh, th, uh, vh;
+	float lf, tf, uf, vf;
+	int i, num, numh, numf, bad_runtime, bad_fixed, bad_float;
+
+	change_radcurv(radcurv);
+	bad_runtime = bad_fixed = bad_float = 0;
+	for (i = 0; i < RS_CHECK_QUERIES; i++)
+	{
+		scale = radcurv * ((i % 3 == 0) ? 0.05 : (i % 3 == 1) ? 2 : 20);
+		x1 = uniform(-10, 10);
+		y1 = uniform(-10, 10);
+		t1 = (i % 4 == 0) ? 0 : uniform(-PI, PI);
+		x2 = x1 + ((i % 8 == 0) ? 0 : uniform(-scale, scale));
+		y2 = y1 + ((i % 8 == 4) ? 0 : uniform(-scale, scale));
+		t2 = (i % 4 == 1) ? t1 + (rand() % 5 - 2) * PI / 2 : t1 + uniform(-2 * PI, 2 * PI);
+
+		l = reed_shepp(x1, y1, t1, x2, y2, t2, &num, &tr, &ur, &vr);
+
+		lh = runtime.solve(x1, y1, t1, x2, y2, t2, numh, th, uh, vh);
+		if ((lh != l) || (numh != num) || (th != tr) || (uh != ur) || (vh != vr)) bad_runtime++;
+
+		lh = fixed.solve(x1, y1, t1, x2, y2, t2, numh, th, uh, vh);
+		if ((lh != l) || (numh != num) || (th != tr) || (uh != ur) || (vh != vr)) bad_fixed++;
+
+		/* against reed_shepp for the query rounded to float */
+		l = reed_shepp((float)x1, (float)y1, (float)t1, (float)x2, (float)y2, (float)t2, &num, &tr, &ur, &vr);
+		lf = single.solve((float)x1, (float)y1, (float)t1, (float)x2, (float)y2, (float)t2, numf, tf, uf, vf);
+		if (!(std::fabs(lf - l) <= RS_CHECK_TOLERANCE_F * (radcurv + l)) || (numf < 1) || (numf > 48)) bad_float++;
+	}
+
+	printf("radius %g\n", radcurv);
+	report("ReedsShepp<double>", bad_runtime, RS_CHECK_QUERIES);
+	report(name, bad_fixed, RS_CHECK_QUERIES);
+	report("ReedsShepp<float>", bad_float, RS_CHECK_QUERIES);
+}
+
+
+/***********************************************************/
+int main(void)
+{
+	srand(1);
+	check(1.0, ReedsShepp<double, std::ratio<1> >(), "ReedsShepp<double, std::ratio<1> >");
+	check(2.5, ReedsShepp<double, std::ratio<5, 2> >(), "ReedsShepp<double, std::ratio<5, 2> >");
+
+	printf("%s\n", (failures == 0) ? "all checks passed" : "some checks failed");
+	return((failures == 0) ? 0 : 1);
+}
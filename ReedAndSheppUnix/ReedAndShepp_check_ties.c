@@ -0,0 +1,130 @@
+// ReedAndShepp_check_ties.c : compares the solver with the one computed with libm.
+//
+// Built and run by "make check". ReedAndShepp_check_fast.so is the scalar
+// solver with the functions of ReedAndShepp_math.h, ReedAndShepp_check_libm.so
+// the same built with RS_MATH_LIBM, where they are the ones of libm. Both
+// are loaded side by side, and solve queries where several curves have the
+// same length: the goal on an axis of the start, headings changed by a
+// multiple of pi / 2, integer coordinates. The lengths must agree within
+// RS_CHECK_TOLERANCE, and when the curves differ, the one of the fast
+// solver must be as short as the one of libm, computed with libm. Exits
+// with 1 when any query disagrees.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <dlfcn.h>
+
+#define RS_CHECK_QUERIES 200000
+#define RS_CHECK_TOLERANCE 1e-12
+
+#define PI 3.14159265358979323846
+
+typedef void (*rs_change_radcurv_fn)(double radcurv);
+typedef double (*rs_reed_shepp_fn)(double x1, double y1, double t1, double x2, double y2, double t2,
+	int* numero, double* tr, double* ur, double* vr);
+typedef double (*rs_filtered_fn)(double x1, double y1, double t1, double x2, double y2, double t2, unsigned long long mask,
+	int* numero, double* tr, double* ur, double* vr);
+
+/* the functions of one of the two libraries */
+typedef struct
+{
+	void* handle;
+	rs_change_radcurv_fn change_radcurv;
+	rs_reed_shepp_fn reed_shepp;
+	rs_filtered_fn reed_shepp_filtered;
+} rs_check_lib;
+
+
+/***********************************************************/
+static double uniform(double a, double b)
+{
+	return(a + (b - a) * rand() / (double)RAND_MAX);
+}
+
+
+/***********************************************************/
+static int load(rs_check_lib* lib, const char* path)
+{
+	lib->handle = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+	if (lib->handle == NULL)
+	{
+		printf("%s\n", dlerror());
+		return(0);
+	}
+	lib->change_radcurv = (rs_change_radcurv_fn)dlsym(lib->handle, "change_radcurv");
+	lib->reed_shepp = (rs_reed_shepp_fn)dlsym(lib->handle, "reed_shepp");
+	lib->reed_shepp_filtered = (rs_filtered_fn)dlsym(lib->handle, "reed_shepp_filtered");
+	return((lib->change_radcurv != NULL) && (lib->reed_shepp != NULL) && (lib->reed_shepp_filtered != NULL));
+}
+
+
+/***********************************************************/
+int main(void)
+{
+	const double radii[2] = { 1.0, 2.5 };
+	rs_check_lib fast, libm;
+	double x, y, phi, lf, ll, lw, t, u, v;
+	int r, i, nf, nl, nw, ties, bad;
+
+	if (!load(&fast, "./ReedAndShepp_check_fast.so") || !load(&libm, "./ReedAndShepp_check_libm.so")) return(1);
+
+	srand(1);
+	bad = 0;
+	for (r = 0; r < 2; r++)
+	{
+		fast.change_radcurv(radii[r]);
+		libm.change_radcurv(radii[r]);
+		ties = 0;
+		for (i = 0; i < RS_CHECK_QUERIES; i++)
+		{
+			x = uniform(-10, 10) * radii[r];
+			y = uniform(-10, 10) * radii[r];
+			phi = uniform(-PI, PI);
+			switch (i % 6)
+			{
+			case 0:
+				x = 0;
+				break;
+			case 1:
+				y = 0;
+				break;
+			case 2:
+				phi = (rand() % 5 - 2) * PI / 2;
+				break;
+			case 3:
+				x = 0;
+				phi = (rand() % 5 - 2) * PI / 2;
+				break;
+			case 4:
+				y = 0;
+				phi = (rand() % 5 - 2) * PI / 2;
+				break;
+			case 5:
+				x = floor(x);
+				y = floor(y);
+				break;
+			}
+
+			lf = fast.reed_shepp(0, 0, 0, x, y, phi, &nf, &t, &u, &v);
+			ll = libm.reed_shepp(0, 0, 0, x, y, phi, &nl, &t, &u, &v);
+			if (!(fabs(lf - ll) <= RS_CHECK_TOLERANCE * (radii[r] + ll)))
+			{
+				bad++;
+				continue;
+			}
+			if (nf == nl) continue;
+
+			/* another curve: its length computed with libm */
+			ties++;
+			lw = libm.reed_shepp_filtered(0, 0, 0, x, y, phi, 1ULL << (nf - 1), &nw, &t, &u, &v);
+			if ((nw != nf) || !(fabs(lw - ll) <= RS_CHECK_TOLERANCE * (radii[r] + ll))) bad++;
+		}
+		printf("radius %g: %d / %d queries with another curve of the same length\n", radii[r], ties, RS_CHECK_QUERIES);
+	}
+
+	printf("%d mismatches\n%s\n", bad, (bad == 0) ? "all checks passed" : "some checks failed");
+	dlclose(fast.handle);
+	dlclose(libm.handle);
+	return((bad == 0) ? 0 : 1);
+}
@@ -0,0 +1,187 @@
+// ReedAndShepp_collision.c : collision checking along RS curves.
+//
+
+#include <stdlib.h>
+#include <math.h>
+
+#include "ReedAndShepp.h"
+#include "ReedAndShepp_internal.h"
+
+/*
+
+rs_path_collision_free moves the robot along the path and checks its
+footprint, a set of circles fixed to the robot, against the grid at each
+pose, without storing the poses.
+
+A point of the robot at a distance o of its reference point moves by at
+most (1 + o / radcurv) * ds when the robot moves by ds along the path. The
+poses are therefore taken every step, with step such that every circle
+moves by at most half a cell between two poses. With a distance field,
+when all the circles are farther than that from the obstacles, the next
+pose is taken as far as the smallest clearance allows instead.
+
+Between two poses, a point of a circle is at most a quarter of a cell
+from where it is at the closest of the two, so the circles are checked
+with their radius plus RS_SWEEP cells, which covers all the space they
+sweep. With a bitmap, a circle is in collision when this larger circle
+overlaps an occupied cell. With a distance field, it is in collision when
+the larger radius plus half the diagonal of a cell is more than the
+distance stored for the cell of its center. In both cases the circles
+themselves must be inside the grid.
+
+*/
+
+#define RS_SWEEP 0.25
+
+
+/***********************************************************/
+/*
+Returns 1 when the footprint is free at (x,y,theta). clearance is then
+the length the robot can move along the path and stay free (0 with a
+bitmap).
+*/
+static int rs_pose_free(const rs_grid* grid, const rs_circle* footprint, int ncircles, double radcurv,
+	double x, double y, double theta, double* clearance)
+{
+	double ct, st, cx, cy, r, rr, d, dx, dy, free, halfdiag;
+	int k, i, j, i0, i1, j0, j1;
+
+	ct = cos(theta);
+	st = sin(theta);
+	halfdiag = 0.5 * sqrt(2.0) * grid->resolution;
+	*clearance = HUGE_VAL;
+
+	for (k = 0; k < ncircles; k++)
+	{
+		cx = x + footprint[k].x * ct - footprint[k].y * st - grid->originx;
+		cy = y + footprint[k].x * st + footprint[k].y * ct - grid->originy;
+		r = footprint[k].radius;
+
+		if ((cx - r < 0) || (cy - r < 0)
+			|| (cx + r >= grid->width * grid->resolution) || (cy + r >= grid->height * grid->resolution)) return(0);
+
+		if (grid->distance != NULL)
+		{
+			i = (int)(cx / grid->resolution);
+			j = (int)(cy / grid->resolution);
+			free = grid->distance[(size_t)j * grid->width + i] - r - RS_SWEEP * grid->resolution - halfdiag;
+			if (free < 0) return(0);
+
+			d = sqrt(footprint[k].x * footprint[k].x + footprint[k].y * footprint[k].y);
+			free = free / (1 + d / radcurv);
+			if (free < *clearance) *clearance = free;
+		}
+		else
+		{
+			rr = r + RS_SWEEP * grid->resolution;
+			i0 = (cx - rr > 0) ? (int)((cx - rr) / grid->resolution) : 0;
+			i1 = (int)((cx + rr) / grid->resolution);
+			if (i1 > grid->width - 1) i1 = grid->width - 1;
+			j0 = (cy - rr > 0) ? (int)((cy - rr) / grid->resolution) : 0;
+			j1 = (int)((cy + rr) / grid->resolution);
+			if (j1 > grid->height - 1) j1 = grid->height - 1;
+			for (j = j0; j <= j1; j++)
+				for (i = i0; i <= i1; i++)
+				{
+					if (!grid->occupancy[(size_t)j * grid->width + i]) continue;
+
+					/* distance from the center to the cell */
+					dx = 0;
+					if (cx < i * grid->resolution) dx = i * grid->resolution - cx;
+					else if (cx > (i + 1) * grid->resolution) dx = cx - (i + 1) * grid->resolution;
+					dy = 0;
+					if (cy < j * grid->resolution) dy = j * grid->resolution - cy;
+					else if (cy > (j + 1) * grid->resolution) dy = cy - (j + 1) * grid->resolution;
+					if (dx * dx + dy * dy <= rr * rr) return(0);
+				}
+			*clearance = 0;
+		}
+	}
+
+	return(1);
+}
+
+
+/***********************************************************/
+EXPORT
+int rs_path_collision_free(const rs_path* path, const rs_circle* footprint, int ncircles, const rs_grid* grid, double* free_length)
+{
+	const rs_path_segment* seg;
+	double length, step, reach, d, s, start, x, y, theta, sx, sy, st, clearance, last;
+	int i, k;
+
+	/* step for which every circle moves by at most half a cell */
+	reach = 0;
+	for (k = 0; k < ncircles; k++)
+	{
+		d = sqrt(footprint[k].x * footprint[k].x + footprint[k].y * footprint[k].y);
+		if (d > reach) reach = d;
+	}
+	step = 0.5 * grid->resolution / (1 + reach / path->radcurv);
+
+	length = rs_path_length(path);
+
+	/* start of the segment i, which begins at the length start */
+	i = 0;
+	start = 0;
+	sx = path->x;
+	sy = path->y;
+	st = path->theta;
+
+	last = 0;
+	s = 0;
+	for (;;)
+	{
+		while ((i < path->nsegments - 1) && (s > start + path->segments[i].length))
+		{
+			seg = &path->segments[i];
+			rs_segment_pose(path->radcurv, seg->type, seg->direction, seg->length, &sx, &sy, &st);
+			start = start + seg->length;
+			i++;
+		}
+
+		x = sx;
+		y = sy;
+		theta = st;
+		if (path->nsegments > 0)
+		{
+			seg = &path->segments[i];
+			rs_segment_pose(path->radcurv, seg->type, seg->direction, s - start, &x, &y, &theta);
+		}
+
+		if (!rs_pose_free(grid, footprint, ncircles, path->radcurv, x, y, theta, &clearance))
+		{
+			if (free_length != NULL) *free_length = last;
+			return(0);
+		}
+
+		last = s;
+		if (s >= length) break;
+		s = s + ((clearance > step) ? clearance : step);
+		if (s > length) s = length;
+	}
+
+	if (free_length != NULL) *free_length = length;
+	return(1);
+}
+
+
+/***********************************************************/
+EXPORT
+int rs_collision_free_ctx(const rs_context* ctx, int num, double t, double u, double v, double x1, double y1, double t1,
+	const rs_circle* footprint, int ncircles, const rs_grid* grid, double* free_length)
+{
+	rs_path path;
+
+	rs_path_from_word_ctx(ctx, &path, num, t, u, v, x1, y1, t1);
+	return(rs_path_collision_free(&path, footprint, ncircles, grid, free_length));
+}
+
+
+/***********************************************************/
+EXPORT
+int rs_collision_free(int num, double t, double u, double v, double x1, double y1, double t1,
+	const rs_circle* footprint, int ncircles, const rs_grid* grid, double* free_length)
+{
+	return(rs_collision_free_ctx(&rs_default, num, t, u, v, x1, y1, t1, footprint, ncircles, grid, free_length));
+}
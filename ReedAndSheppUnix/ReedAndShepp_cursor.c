@@ -0,0 +1,291 @@
+// ReedAndShepp_cursor.c : discretized RS curves, one point at a time.
+//
+
+#include <math.h>
+
+#include "ReedAndShepp.h"
+#include "ReedAndShepp_internal.h"
+
+/*
+
+rs_cursor_next does the same computations as fct_curve, in the same
+order, so that it gives the same points as constRS.
+
+fct_curve writes the points of a segment after the ones already written,
+then its last point, which replaces the previous point when the end of
+the segment is too close to it. The cursor therefore keeps the last point
+(px,py,pt) until it knows it will not be replaced.
+
+phase is RS_CURSOR_SEGMENT before a segment, RS_CURSOR_POINTS while
+giving its points, RS_CURSOR_END after the last segment and RS_CURSOR_DONE
+once the last point is given. During a segment, step counts the points
+given out of nsteps. For an arc, (cx,cy) is its center, angle the angle
+of the current point on the circle, dangle its increment and incrt the
+increment of the orientation since the start of the segment. For a
+straight line, (cx,cy) is its direction and angle the distance of the
+current point from the start.
+
+*/
+
+#define RS_CURSOR_SEGMENT 0
+#define RS_CURSOR_POINTS 1
+#define RS_CURSOR_END 2
+#define RS_CURSOR_DONE 3
+
+
+/***********************************************************/
+EXPORT
+void rs_cursor_init_ctx(rs_cursor* cursor, const rs_context* ctx, int num, double t, double u, double v, double x1, double y1, double t1, double delta)
+{
+	cursor->radcurv = ctx->radcurv;
+	cursor->delta = delta;
+	if (ctx->sampling == RS_SAMPLING_UNIFORM)
+	{
+		cursor->line_step = ctx->radcurv * delta;
+		cursor->line_threshold = cursor->line_step / 5.;
+	}
+	else
+	{
+		cursor->line_step = 1.2;
+		cursor->line_threshold = 0.4;
+	}
+	cursor->lengths[RS_T] = t;
+	cursor->lengths[RS_U] = u;
+	cursor->lengths[RS_V] = v;
+	cursor->lengths[RS_HALFPI] = MPIDIV2;
+	cursor->num = num;
+	cursor->segment = 0;
+	cursor->phase = ((num >= 1) && (num <= 48)) ? RS_CURSOR_SEGMENT : RS_CURSOR_END;
+	cursor->x = x1;
+	cursor->y = y1;
+	cursor->theta = t1;
+	cursor->px = x1;
+	cursor->py = y1;
+	cursor->pt = t1;
+}
+
+
+/***********************************************************/
+EXPORT
+void rs_cursor_init(rs_cursor* cursor, int num, double t, double u, double v, double x1, double y1, double t1, double delta)
+{
+	rs_cursor_init_ctx(cursor, &rs_default, num, t, u, v, x1, y1, t1, delta);
+}
+
+
+/***********************************************************/
+/*
+Prepares the next segment of length other than 0. Returns 0 when there
+is none left.
+*/
+static int rs_cursor_segment(rs_cursor* c)
+{
+	const rs_segment* seg;
+	double val, va2, sdelta;
+	int orientation;
+
+	for (; c->segment < RS_MAX_SEGMENTS; c->segment++)
+	{
+		seg = &rs_words[c->num - 1][c->segment];
+		if (seg->type == 0) return(0);
+
+		val = c->lengths[seg->length];
+		orientation = seg->orientation;
+
+		if (seg->type == RS_STRAIGHT)
+		{
+			if (fabs(val / c->radcurv)<EPS4) continue;
+
+			c->x2 = c->x + orientation * val*cos(c->theta);
+			c->y2 = c->y + orientation * val*sin(c->theta);
+			c->theta = mod2pi(c->theta);
+			c->t2 = c->theta;
+
+			val = sqrt((c->x2 - c->x)*(c->x2 - c->x) + (c->y2 - c->y)*(c->y2 - c->y));
+			c->nsteps = val / c->line_step;
+			c->remain = val - c->nsteps * c->line_step;
+			c->threshold = c->line_threshold;
+			c->angle = c->line_step;
+			c->cx = orientation * cos(c->theta);
+			c->cy = orientation * sin(c->theta);
+		}
+		else
+		{
+			if (fabs(val)<EPS4) continue;
+
+			sdelta = (orientation == -1) ? -c->delta : c->delta;
+			if (seg->type == RS_RIGHT)
+			{
+				c->cx = c->x + c->radcurv * sin(c->theta);
+				c->cy = c->y - c->radcurv * cos(c->theta);
+				c->angle = c->theta + MPIDIV2;
+				if (orientation == 1) va2 = c->angle - val;
+				else va2 = c->angle + val;
+				c->t2 = c->theta - orientation * val;
+				c->dangle = -sdelta;
+			}
+			else
+			{
+				c->cx = c->x - c->radcurv * sin(c->theta);
+				c->cy = c->y + c->radcurv * cos(c->theta);
+				c->angle = c->theta - MPIDIV2;
+				if (orientation == 1) va2 = c->angle + val;
+				else va2 = c->angle - val;
+				c->t2 = c->theta + orientation * val;
+				c->dangle = sdelta;
+			}
+			c->x2 = c->cx + c->radcurv * cos(va2);
+			c->y2 = c->cy + c->radcurv * sin(va2);
+
+			c->nsteps = val / c->delta;
+			c->remain = val - c->nsteps * c->delta;
+			c->threshold = c->delta / 5.;
+			c->incrt = 0;
+		}
+
+		c->step = 0;
+		return(1);
+	}
+
+	return(0);
+}
+
+
+/***********************************************************/
+EXPORT
+int rs_cursor_next(rs_cursor* c, double* x, double* y, double* theta)
+{
+	double nx, ny, nt;
+	const rs_segment* seg;
+
+	for (;;)
+	{
+		if (c->phase == RS_CURSOR_DONE) return(0);
+
+		if (c->phase == RS_CURSOR_END)
+		{
+			*x = c->px;
+			*y = c->py;
+			*theta = c->pt;
+			c->phase = RS_CURSOR_DONE;
+			return(1);
+		}
+
+		if (c->phase == RS_CURSOR_SEGMENT)
+		{
+			c->phase = rs_cursor_segment(c) ? RS_CURSOR_POINTS : RS_CURSOR_END;
+			continue;
+		}
+
+		if (c->step < c->nsteps)
+		{
+			seg = &rs_words[c->num - 1][c->segment];
+			if (seg->type == RS_STRAIGHT)
+			{
+				nx = c->x + c->cx * c->angle;
+				ny = c->y + c->cy * c->angle;
+				nt = c->theta;
+				c->angle = c->angle + c->line_step;
+			}
+			else
+			{
+				c->angle = c->angle + c->dangle;
+				nx = c->cx + c->radcurv * cos(c->angle);
+				ny = c->cy + c->radcurv * sin(c->angle);
+				c->incrt = c->incrt + c->dangle;
+				nt = mod2pi(c->theta + c->incrt);
+			}
+			c->step++;
+		}
+		else
+		{
+			/* end of the segment */
+			nx = c->x2;
+			ny = c->y2;
+			nt = mod2pi(c->t2);
+			c->x = c->x2;
+			c->y = c->y2;
+			c->theta = c->t2;
+			c->segment++;
+			c->phase = RS_CURSOR_SEGMENT;
+
+			if (!(c->remain > c->threshold))
+			{
+				c->px = nx;
+				c->py = ny;
+				c->pt = nt;
+				continue;
+			}
+		}
+
+		*x = c->px;
+		*y = c->py;
+		*theta = c->pt;
+		c->px = nx;
+		c->py = ny;
+		c->pt = nt;
+		return(1);
+	}
+}
+
+
+/***********************************************************/
+EXPORT
+int constRS_count_ctx(const rs_context* ctx, int num, double t, double u, double v, double x1, double y1, double t1, double delta)
+{
+	rs_cursor c;
+	int n;
+
+	rs_cursor_init_ctx(&c, ctx, num, t, u, v, x1, y1, t1, delta);
+	if (c.phase == RS_CURSOR_END) return(1);
+
+	/* same segments as rs_cursor_next, without computing their points */
+	n = 1;
+	while (rs_cursor_segment(&c))
+	{
+		n += c.nsteps;
+		if (c.remain > c.threshold) n++;
+		c.x = c.x2;
+		c.y = c.y2;
+		c.theta = c.t2;
+		c.segment++;
+	}
+
+	return(n);
+}
+
+
+/***********************************************************/
+EXPORT
+int constRS_count(int num, double t, double u, double v, double x1, double y1, double t1, double delta)
+{
+	return(constRS_count_ctx(&rs_default, num, t, u, v, x1, y1, t1, delta));
+}
+
+
+/***********************************************************/
+EXPORT
+int constRS_bounded_ctx(const rs_context* ctx, int num, double t, double u, double v, double x1, double y1, double t1, double delta,
+	int capacity, double* pathx, double* pathy, double* patht, int* truncated)
+{
+	rs_cursor c;
+	double x, y, theta;
+	int n;
+
+	rs_cursor_init_ctx(&c, ctx, num, t, u, v, x1, y1, t1, delta);
+	for (n = 0; n < capacity; n++)
+		if (!rs_cursor_next(&c, pathx + n, pathy + n, patht + n)) break;
+
+	*truncated = (n == capacity) && rs_cursor_next(&c, &x, &y, &theta);
+	if (__atomic_load_n(&rs_stats_enabled, __ATOMIC_RELAXED)) rs_stats_add_path(n);
+	return(n);
+}
+
+
+/***********************************************************/
+EXPORT
+int constRS_bounded(int num, double t, double u, double v, double x1, double y1, double t1, double delta,
+	int capacity, double* pathx, double* pathy, double* patht, int* truncated)
+{
+	return(constRS_bounded_ctx(&rs_default, num, t, u, v, x1, y1, t1, delta, capacity, pathx, pathy, patht, truncated));
+}
@@ -0,0 +1,512 @@
+// ReedAndShepp_index.c : nearest neighbours for the length of the RS curves.
+//
+
+#include <stdlib.h>
+#include <math.h>
+
+#include "ReedAndShepp.h"
+#include "ReedAndShepp_internal.h"
+
+/*
+
+An rs_index puts the configurations in a grid of square cells of side
+cell over the plane, found through a hash table, so that configurations
+can be added at any time.
+
+The length of an RS curve between two configurations is at least their
+distance in the plane, and at least radcurv times the difference of their
+orientations (in [0,pi]), since the curve turns by that angle at most one
+radian for every radcurv units of length. A query visits the rings of
+cells around the cell of the query configuration, closest first, and stops
+when the distance in the plane to the ring exceeds the k-th best length
+found (or the radius). In a ring, it computes the lower bound of each
+configuration and only computes the length of the RS curve when the bound
+is below the k-th best length.
+
+*/
+
+typedef struct
+{
+	int cx, cy;
+	int count, capacity;
+	int* items;
+} rs_index_cell;
+
+struct rs_index
+{
+	rs_context ctx;
+	double cell;
+	int count, capacity;
+	double *x, *y, *theta;
+	int ncells, cellcapacity;
+	rs_index_cell* cells;
+	int hashsize;		/* power of 2, at least twice ncells */
+	int* hash;			/* index in cells, -1 when empty */
+	int mincx, maxcx, mincy, maxcy;
+};
+
+
+/***********************************************************/
+static unsigned int rs_index_hash(int cx, int cy)
+{
+	return((unsigned int)cx * 0x9E3779B1u ^ (unsigned int)cy * 0x85EBCA77u);
+}
+
+
+/***********************************************************/
+/*
+Cell coordinate of v, clamped to [-RS_INDEX_FAR, RS_INDEX_FAR] (NaN
+giving -RS_INDEX_FAR) so that it can be converted and compared safely.
+The configurations are only inserted within RS_INDEX_MAXCELL cells of the
+origin, so a query clamped to RS_INDEX_FAR is still farther from all of
+them than the real one, which keeps the bounds of rs_index_scan valid.
+*/
+#define RS_INDEX_MAXCELL 0x3FFFFFFF
+#define RS_INDEX_FAR 0x3FFFFFFFFFFFLL
+
+static long long rs_index_coord(double v, double cell)
+{
+	v = floor(v / cell);
+	if (!(v > -RS_INDEX_FAR)) return(-RS_INDEX_FAR);
+	if (v > RS_INDEX_FAR) return(RS_INDEX_FAR);
+	return((long long)v);
+}
+
+
+/***********************************************************/
+/*
+Returns the slot of the cell (cx,cy) in the hash table, either holding it
+or empty.
+*/
+static int rs_index_slot(const rs_index* index, int cx, int cy)
+{
+	unsigned int h;
+	int c;
+
+	h = rs_index_hash(cx, cy) & (index->hashsize - 1);
+	while ((c = index->hash[h]) >= 0)
+	{
+		if ((index->cells[c].cx == cx) && (index->cells[c].cy == cy)) break;
+		h = (h + 1) & (index->hashsize - 1);
+	}
+	return((int)h);
+}
+
+
+/***********************************************************/
+static const rs_index_cell* rs_index_find(const rs_index* index, int cx, int cy)
+{
+	int c;
+
+	c = index->hash[rs_index_slot(index, cx, cy)];
+	return((c >= 0) ? &index->cells[c] : NULL);
+}
+
+
+/***********************************************************/
+static int rs_index_grow_hash(rs_index* index)
+{
+	int* hash;
+	int i, size;
+
+	size = index->hashsize * 2;
+	hash = (int*)malloc(size * sizeof(int));
+	if (hash == NULL) return(0);
+
+	free(index->hash);
+	index->hash = hash;
+	index->hashsize = size;
+	for (i = 0; i < size; i++) hash[i] = -1;
+	for (i = 0; i < index->ncells; i++) hash[rs_index_slot(index, index->cells[i].cx, index->cells[i].cy)] = i;
+	return(1);
+}
+
+
+/***********************************************************/
+EXPORT
+rs_index* rs_index_create_ctx(const rs_context* ctx, double cell)
+{
+	rs_index* index;
+	int i;
+
+	if (cell <= 0) return(NULL);
+
+	index = (rs_index*)calloc(1, sizeof(rs_index));
+	if (index == NULL) return(NULL);
+
+	index->ctx = *ctx;
+	index->cell = cell;
+	index->hashsize = 64;
+	index->hash = (int*)malloc(index->hashsize * sizeof(int));
+	if (index->hash == NULL)
+	{
+		free(index);
+		return(NULL);
+	}
+	for (i = 0; i < index->hashsize; i++) index->hash[i] = -1;
+	return(index);
+}
+
+
+/***********************************************************/
+EXPORT
+rs_index* rs_index_create(double cell)
+{
+	return(rs_index_create_ctx(&rs_default, cell));
+}
+
+
+/***********************************************************/
+EXPORT
+void rs_index_destroy(rs_index* index)
+{
+	int i;
+
+	if (index == NULL) return;
+	for (i = 0; i < index->ncells; i++) free(index->cells[i].items);
+	free(index->cells);
+	free(index->hash);
+	free(index->x);
+	free(index->y);
+	free(index->theta);
+	free(index);
+}
+
+
+/***********************************************************/
+EXPORT
+int rs_index_size(const rs_index* index)
+{
+	return(index->count);
+}
+
+
+/***********************************************************/
+EXPORT
+int rs_index_insert(rs_index* index, double x, double y, double theta)
+{
+	rs_index_cell* cell;
+	void* p;
+	long long kx, ky;
+	int cx, cy, slot, c, capacity;
+
+	/* configurations */
+	if (index->count == index->capacity)
+	{
+		capacity = (index->capacity > 0) ? 2 * index->capacity : 256;
+		p = realloc(index->x, capacity * sizeof(double));
+		if (p == NULL) return(-1);
+		index->x = (double*)p;
+		p = realloc(index->y, capacity * sizeof(double));
+		if (p == NULL) return(-1);
+		index->y = (double*)p;
+		p = realloc(index->theta, capacity * sizeof(double));
+		if (p == NULL) return(-1);
+		index->theta = (double*)p;
+		index->capacity = capacity;
+	}
+
+	/* cell, created if needed */
+	kx = rs_index_coord(x, index->cell);
+	ky = rs_index_coord(y, index->cell);
+	if ((kx < -RS_INDEX_MAXCELL) || (kx > RS_INDEX_MAXCELL) || (ky < -RS_INDEX_MAXCELL) || (ky > RS_INDEX_MAXCELL)) return(-1);
+	cx = (int)kx;
+	cy = (int)ky;
+	if (2 * (index->ncells + 1) > index->hashsize)
+		if (!rs_index_grow_hash(index)) return(-1);
+
+	slot = rs_index_slot(index, cx, cy);
+	c = index->hash[slot];
+	if (c < 0)
+	{
+		if (index->ncells == index->cellcapacity)
+		{
+			capacity = (index->cellcapacity > 0) ? 2 * index->cellcapacity : 64;
+			p = realloc(index->cells, capacity * sizeof(rs_index_cell));
+			if (p == NULL) return(-1);
+			index->cells = (rs_index_cell*)p;
+			index->cellcapacity = capacity;
+		}
+		c = index->ncells++;
+		index->cells[c].cx = cx;
+		index->cells[c].cy = cy;
+		index->cells[c].count = 0;
+		index->cells[c].capacity = 0;
+		index->cells[c].items = NULL;
+		index->hash[slot] = c;
+
+		if ((c == 0) || (cx < index->mincx)) index->mincx = cx;
+		if ((c == 0) || (cx > index->maxcx)) index->maxcx = cx;
+		if ((c == 0) || (cy < index->mincy)) index->mincy = cy;
+		if ((c == 0) || (cy > index->maxcy)) index->maxcy = cy;
+	}
+
+	cell = &index->cells[c];
+	if (cell->count == cell->capacity)
+	{
+		capacity = (cell->capacity > 0) ? 2 * cell->capacity : 8;
+		p = realloc(cell->items, capacity * sizeof(int));
+		if (p == NULL) return(-1);
+		cell->items = (int*)p;
+		cell->capacity = capacity;
+	}
+
+	index->x[index->count] = x;
+	index->y[index->count] = y;
+	index->theta[index->count] = theta;
+	cell->items[cell->count++] = index->count;
+	return(index->count++);
+}
+
+
+/***********************************************************/
+/*
+Lower bound of the length of the RS curves between the configuration q of
+the query and the configuration i of the index.
+*/
+static double rs_index_bound(const rs_index* index, double qx, double qy, double qtheta, int i)
+{
+	double d, a;
+
+	d = sqrt((index->x[i] - qx) * (index->x[i] - qx) + (index->y[i] - qy) * (index->y[i] - qy));
+	a = mod2pi(index->theta[i] - qtheta);
+	if (a > MPI) a = MPIMUL2 - a;
+	a = index->ctx.radcurv * a;
+	return((d > a) ? d : a);
+}
+
+
+/***********************************************************/
+/*
+Distance in the plane from (qx,qy) to the cell (cx,cy).
+*/
+static double rs_index_cell_distance(const rs_index* index, double qx, double qy, int cx, int cy)
+{
+	double dx, dy;
+
+	dx = 0;
+	if (qx < cx * index->cell) dx = cx * index->cell - qx;
+	else if (qx > (cx + 1) * index->cell) dx = qx - (cx + 1) * index->cell;
+	dy = 0;
+	if (qy < cy * index->cell) dy = cy * index->cell - qy;
+	else if (qy > (cy + 1) * index->cell) dy = qy - (cy + 1) * index->cell;
+	return(sqrt(dx * dx + dy * dy));
+}
+
+
+/***********************************************************/
+/*
+Visits the rings of cells around (qx,qy), closest first. For each
+configuration whose lower bound is below *limit, calls visit, which may
+lower *limit. Stops when the ring is farther than *limit. Only the part of
+a ring inside the box of the cells of the index is visited, and the rings
+that do not reach the box are skipped, so that a query far from the
+configurations does not visit empty cells. Once a ring has more cells than
+the index, as for a query among sparse configurations far apart, the
+cells of the index outside the rings visited are visited instead, in no
+particular order, which costs at most one pass over the index.
+*/
+typedef void (*rs_index_visit_fn)(void* data, int i, double length, double* limit);
+
+static void rs_index_visit_cell(const rs_index* index, const rs_index_cell* cell, double qx, double qy, double qtheta,
+	double* limit, rs_index_visit_fn visit, void* data)
+{
+	double lb, length;
+	int k, i;
+
+	for (k = 0; k < cell->count; k++)
+	{
+		i = cell->items[k];
+		lb = rs_index_bound(index, qx, qy, qtheta, i);
+		if (lb > *limit) continue;
+		length = reed_shepp_length_ctx(&index->ctx, qx, qy, qtheta, index->x[i], index->y[i], index->theta[i]);
+		visit(data, i, length, limit);
+	}
+}
+
+static void rs_index_scan(const rs_index* index, double qx, double qy, double qtheta, double* limit, rs_index_visit_fn visit, void* data)
+{
+	const rs_index_cell* cell;
+	long long qcx, qcy, r, rmin, rmax, cx, cy, x0, x1, y0, y1;
+	int c, edge;
+
+	if (index->count == 0) return;
+
+	qcx = rs_index_coord(qx, index->cell);
+	qcy = rs_index_coord(qy, index->cell);
+
+	/* first and last rings that hold some cell of the index */
+	rmin = 0;
+	if (qcx < index->mincx) rmin = index->mincx - qcx;
+	if (qcx > index->maxcx) rmin = qcx - index->maxcx;
+	if ((qcy < index->mincy) && (index->mincy - qcy > rmin)) rmin = index->mincy - qcy;
+	if ((qcy > index->maxcy) && (qcy - index->maxcy > rmin)) rmin = qcy - index->maxcy;
+	rmax = llabs(qcx - index->mincx);
+	if (llabs(qcx - index->maxcx) > rmax) rmax = llabs(qcx - index->maxcx);
+	if (llabs(qcy - index->mincy) > rmax) rmax = llabs(qcy - index->mincy);
+	if (llabs(qcy - index->maxcy) > rmax) rmax = llabs(qcy - index->maxcy);
+
+	for (r = rmin; r <= rmax; r++)
+	{
+		if ((r - 1) * index->cell > *limit) break;
+
+		/* sparse: the remaining cells of the index rather than the rings */
+		if (8 * r > index->ncells)
+		{
+			for (c = 0; c < index->ncells; c++)
+			{
+				cell = &index->cells[c];
+				if ((llabs(cell->cx - qcx) < r) && (llabs(cell->cy - qcy) < r)) continue;
+				if (rs_index_cell_distance(index, qx, qy, cell->cx, cell->cy) > *limit) continue;
+				rs_index_visit_cell(index, cell, qx, qy, qtheta, limit, visit, data);
+			}
+			break;
+		}
+
+		/* the ring, clipped to the box */
+		x0 = (qcx - r < index->mincx) ? index->mincx : qcx - r;
+		x1 = (qcx + r > index->maxcx) ? index->maxcx : qcx + r;
+		y0 = (qcy - r < index->mincy) ? index->mincy : qcy - r;
+		y1 = (qcy + r > index->maxcy) ? index->maxcy : qcy + r;
+
+		for (cy = y0; cy <= y1; cy++)
+		{
+			/* inner rows of the ring: only the two ends */
+			edge = (cy == qcy - r) || (cy == qcy + r) || (r == 0);
+			for (cx = edge ? x0 : qcx - r; cx <= (edge ? x1 : qcx + r); cx += edge ? 1 : 2 * r)
+			{
+				if ((cx < x0) || (cx > x1)) continue;
+				if (rs_index_cell_distance(index, qx, qy, (int)cx, (int)cy) > *limit) continue;
+				cell = rs_index_find(index, (int)cx, (int)cy);
+				if (cell == NULL) continue;
+				rs_index_visit_cell(index, cell, qx, qy, qtheta, limit, visit, data);
+			}
+		}
+	}
+}
+
+
+/***********************************************************/
+/*
+k nearest configurations found so far, as a max-heap on the length.
+*/
+typedef struct
+{
+	int k, count;
+	int* ids;
+	double* lengths;
+} rs_index_heap;
+
+static void rs_index_visit_knn(void* data, int i, double length, double* limit)
+{
+	rs_index_heap* heap;
+	int p, c;
+
+	heap = (rs_index_heap*)data;
+	if (heap->count < heap->k)
+	{
+		/* sift up */
+		for (c = heap->count++; c > 0; c = p)
+		{
+			p = (c - 1) / 2;
+			if (heap->lengths[p] >= length) break;
+			heap->lengths[c] = heap->lengths[p];
+			heap->ids[c] = heap->ids[p];
+		}
+	}
+	else
+	{
+		if (length >= heap->lengths[0]) return;
+		/* sift down from the root */
+		for (p = 0; (c = 2 * p + 1) < heap->count; p = c)
+		{
+			if ((c + 1 < heap->count) && (heap->lengths[c + 1] > heap->lengths[c])) c++;
+			if (heap->lengths[c] <= length) break;
+			heap->lengths[p] = heap->lengths[c];
+			heap->ids[p] = heap->ids[c];
+		}
+		c = p;
+	}
+	heap->lengths[c] = length;
+	heap->ids[c] = i;
+
+	if (heap->count == heap->k) *limit = heap->lengths[0];
+}
+
+
+/***********************************************************/
+EXPORT
+int rs_index_knn(const rs_index* index, double x, double y, double theta, int k, int* ids, double* lengths)
+{
+	rs_index_heap heap;
+	double limit, l;
+	int i, j, id;
+
+	if (k <= 0) return(0);
+
+	heap.k = k;
+	heap.count = 0;
+	heap.ids = ids;
+	heap.lengths = lengths;
+	limit = HUGE_VAL;
+	rs_index_scan(index, x, y, theta, &limit, rs_index_visit_knn, &heap);
+
+	/* heap to increasing lengths */
+	for (i = 1; i < heap.count; i++)
+	{
+		l = lengths[i];
+		id = ids[i];
+		for (j = i; (j > 0) && (lengths[j - 1] > l); j--)
+		{
+			lengths[j] = lengths[j - 1];
+			ids[j] = ids[j - 1];
+		}
+		lengths[j] = l;
+		ids[j] = id;
+	}
+
+	return(heap.count);
+}
+
+
+/***********************************************************/
+typedef struct
+{
+	double radius;
+	int capacity, count;
+	int* ids;
+	double* lengths;
+} rs_index_range;
+
+static void rs_index_visit_radius(void* data, int i, double length, double* limit)
+{
+	rs_index_range* range;
+
+	range = (rs_index_range*)data;
+	if (length > range->radius) return;
+	if (range->count < range->capacity)
+	{
+		range->ids[range->count] = i;
+		range->lengths[range->count] = length;
+	}
+	range->count++;
+	(void)limit;
+}
+
+
+/***********************************************************/
+EXPORT
+int rs_index_radius(const rs_index* index, double x, double y, double theta, double radius, int capacity, int* ids, double* lengths)
+{
+	rs_index_range range;
+	double limit;
+
+	range.radius = radius;
+	range.capacity = capacity;
+	range.count = 0;
+	range.ids = ids;
+	range.lengths = lengths;
+	limit = radius;
+	rs_index_scan(index, x, y, theta, &limit, rs_index_visit_radius, &range);
+	return(range.count);
+}
@@ -0,0 +1,152 @@
+// ReedAndShepp_internal.h : definitions shared by the files of the library.
+//
+
+#ifndef REEDANDSHEPP_INTERNAL_H
+#define REEDANDSHEPP_INTERNAL_H
+
+#include "ReedAndShepp.h"
+
+#define EXPORT __attribute__((visibility("default")))
+
+#define EPS1 1.0e-12
+#define EPS2 1.0e-12
+#define EPS3 1.0e-12
+#define EPS4 1.0e-12
+#define INFINITY 10000
+
+#define MPI 3.1415926536
+#define MPIMUL2 6.2831853072
+#define MPIDIV2 1.5707963268
+
+
+/*
+
+An rs_context holds the turning radius and the constants derived from it,
+read by all the functions that compute RS curves.
+
+radcurv is the radius of the circular arcs in the RS curves (the
+turning radius of the robot). It is in whatever units you want.
+
+radcurvmul2 is defined as 2 * radcurv
+radcurvmul4 is defined as 4 * radcurv
+sqradcurv   is defined as radcurv * radcurv
+sqradcurvmul2 is defined as 4 * radcurv * radcurv
+
+sampling is the way constRS places the points on straight lines
+(RS_SAMPLING_LEGACY or RS_SAMPLING_UNIFORM).
+
+scan is the way reed_shepp scans the curves (RS_SCAN_FULL or
+RS_SCAN_CANONICAL).
+
+*/
+
+struct rs_context
+{
+	double radcurv;
+	double radcurvmul2;
+	double radcurvmul4;
+	double sqradcurv;
+	double sqradcurvmul2;
+	int sampling;
+	int scan;
+};
+
+/* context of the functions that do not take one, defined in ReedAndShepp.c */
+extern rs_context rs_default;
+
+double mod2pi(double angle);
+
+
+/*
+
+rs_words describes the segments of the 48 RS curves, in the order constRS
+draws them: the type of each segment (RS_RIGHT, RS_LEFT or RS_STRAIGHT, 0
+after the last one), its direction (1 forward, -1 backward) and which of
+t, u, v or pi/2 is its length. The types are the ones of fct_curve.
+
+*/
+
+#define RS_T 0
+#define RS_U 1
+#define RS_V 2
+#define RS_HALFPI 3
+
+#define RS_MAX_SEGMENTS 5
+
+typedef struct
+{
+	signed char type;
+	signed char orientation;
+	signed char length;
+} rs_segment;
+
+extern const rs_segment rs_words[48][RS_MAX_SEGMENTS];
+
+/* moves (x,y,theta) by the length s along a segment, see ReedAndShepp_path.c */
+void rs_segment_pose(double radcurv, int type, int direction, double s, double* x, double* y, double* theta);
+
+
+/*
+
+Counters of rs_stats, see ReedAndShepp_stats.c. The solver reads
+rs_stats_enabled and, when it is set, measures its scan with
+rs_stats_clock and gives rs_stats_add_solve the curves chosen for n
+increments and the number of rejections of each family for the sampled
+ones among them. constRS gives
+rs_stats_add_path the number of points of each path.
+
+*/
+
+extern int rs_stats_enabled;
+
+unsigned long long rs_stats_clock(void);
+void rs_stats_add_solve(int n, const int* numero, int sampled, const unsigned int* rejections, unsigned long long cycles);
+void rs_stats_add_path(int samples);
+
+
+/*
+
+rs_solve_fn scans the 48 RS curves, for the radius of ctx, for n
+increments of configuration
+(x[i],y[i],phi[i]) and writes the shortest curve of each one in
+length[i], numero[i], tr[i], ur[i] and vr[i].
+
+ReedAndShepp_simd.c is compiled once per instruction set (SSE4.2, AVX2,
+AVX-512), each time defining its own rs_solve_<isa>, and once more per
+instruction set with RS_SIMD_FLOAT for rs_solve_f_<isa>. When the library is
+built with these objects, RS_DISPATCH is defined and the initializer of
+ReedAndShepp.c picks the best one supported by the CPU.
+
+*/
+
+typedef void (*rs_solve_fn)(const rs_context* ctx, int n, const double* x, const double* y, const double* phi,
+	double* length, int* numero, double* tr, double* ur, double* vr);
+
+/* the same in single precision, for reed_shepp_f and reed_shepp_batch_f */
+typedef void (*rs_solve_f_fn)(const rs_context* ctx, int n, const float* x, const float* y, const float* phi,
+	float* length, int* numero, float* tr, float* ur, float* vr);
+
+#ifdef RS_DISPATCH
+void rs_solve_sse42(const rs_context* ctx, int n, const double* x, const double* y, const double* phi,
+	double* length, int* numero, double* tr, double* ur, double* vr);
+void rs_solve_avx2(const rs_context* ctx, int n, const double* x, const double* y, const double* phi,
+	double* length, int* numero, double* tr, double* ur, double* vr);
+void rs_solve_avx512(const rs_context* ctx, int n, const double* x, const double* y, const double* phi,
+	double* length, int* numero, double* tr, double* ur, double* vr);
+void rs_solve_f_sse42(const rs_context* ctx, int n, const float* x, const float* y, const float* phi,
+	float* length, int* numero, float* tr, float* ur, float* vr);
+void rs_solve_f_avx2(const rs_context* ctx, int n, const float* x, const float* y, const float* phi,
+	float* length, int* numero, float* tr, float* ur, float* vr);
+void rs_solve_f_avx512(const rs_context* ctx, int n, const float* x, const float* y, const float* phi,
+	float* length, int* numero, float* tr, float* ur, float* vr);
+
+/*
+Picks the scans of the instruction set wanted ("scalar", "sse42", "avx2"
+or "avx512"), or of the best one supported by the CPU when it is NULL or
+not supported. Called at load time with RS_ISA, and by
+ReedAndShepp_check.c to compare them.
+*/
+void rs_select_isa(const char* wanted);
+#endif
+
+#endif
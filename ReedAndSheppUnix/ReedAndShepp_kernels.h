@@ -0,0 +1,282 @@
+// ReedAndShepp_kernels.h : the 12 functions of families of RS curves.
+//
+
+#ifndef REEDANDSHEPP_KERNELS_H
+#define REEDANDSHEPP_KERNELS_H
+
+/*
+
+The functions c_c_c through csc2_cb, written once for ReedAndShepp.c and
+ReedAndShepp.hpp. They compute on the type vd of ReedAndShepp_math.h,
+which must be included first, with rs_atan2, rs_acos, rs_asin and
+rs_mod2pi, and read the radius from ctx->radcurv, ctx->radcurvmul2,
+ctx->radcurvmul4, ctx->sqradcurv and ctx->sqradcurvmul2. A curve that
+does not exist has the length INFINITY.
+
+ReedAndShepp.c includes this file with RS_KERNEL empty, vd being double,
+rs_context the one of ReedAndShepp_internal.h and INFINITY 10000.
+ReedAndShepp.hpp includes it in the body of its solver, with RS_KERNEL
+defined as static, vd being the Scalar of the solver, rs_context its
+radius and INFINITY the one of <cmath>; it also defines EPS3, MPI and
+MPIDIV2 as constants of type Scalar for the time of the include.
+
+*/
+
+/***********************************************************/
+RS_KERNEL vd c_c_c(const rs_context* ctx, vd x, vd y, vd phi, vd rs, vd rc, vd* t, vd* u, vd* v)
+{
+	vd a, b, u1, theta, alpha, length_rs;
+
+	a = x - rs;
+	b = y + rc;
+	if ((fabs(a)<EPS3) && (fabs(b)<EPS3)) return(INFINITY);
+	u1 = sqrt(a*a + b * b);
+	if (u1>ctx->radcurvmul4) return(INFINITY);
+	theta = rs_atan2(b, a);
+	alpha = rs_acos(u1 / ctx->radcurvmul4);
+	*t = rs_mod2pi(MPIDIV2 + alpha + theta);
+	*u = rs_mod2pi(MPI - 2 * alpha);
+	*v = rs_mod2pi(phi - *t - *u);
+
+	length_rs = ctx->radcurv * (*t + *u + *v);
+	return(length_rs);
+}
+
+
+/***********************************************************/
+RS_KERNEL vd c_cc(const rs_context* ctx, vd x, vd y, vd phi, vd rs, vd rc, vd* t, vd* u, vd* v)
+{
+	vd a, b, u1, theta, alpha, length_rs;
+
+	a = x - rs;
+	b = y + rc;
+	if ((fabs(a)<EPS3) && (fabs(b)<EPS3)) return(INFINITY);
+	u1 = sqrt(a*a + b * b);
+	if (u1>ctx->radcurvmul4) return(INFINITY);
+	theta = rs_atan2(b, a);
+	alpha = rs_acos(u1 / ctx->radcurvmul4);
+	*t = rs_mod2pi(MPIDIV2 + alpha + theta);
+	*u = rs_mod2pi(MPI - 2 * alpha);
+	*v = rs_mod2pi(*t + *u - phi);
+
+	length_rs = ctx->radcurv * (*t + *u + *v);
+	return(length_rs);
+}
+
+
+/***********************************************************/
+RS_KERNEL vd csca(const rs_context* ctx, vd x, vd y, vd phi, vd rs, vd rc, vd* t, vd* u, vd* v)
+{
+	vd a, b, length_rs;
+
+	a = x - rs;
+	b = y + rc;
+	*t = rs_mod2pi(rs_atan2(b, a));
+	*u = sqrt(a*a + b * b);
+	*v = rs_mod2pi(phi - *t);
+
+	length_rs = ctx->radcurv * (*t + *v) + *u;
+	return(length_rs);
+}
+
+
+/***********************************************************/
+RS_KERNEL vd cscb(const rs_context* ctx, vd x, vd y, vd phi, vd rs, vd rc, vd* t, vd* u, vd* v)
+{
+	vd a, b, u1, theta, alpha, length_rs;
+
+	a = x + rs;
+	b = y - rc;
+	u1 = sqrt(a*a + b * b);
+	if (u1 < ctx->radcurvmul2) return(INFINITY);
+	theta = rs_atan2(b, a);
+	*u = sqrt(u1*u1 - ctx->sqradcurvmul2);
+	alpha = rs_atan2(ctx->radcurvmul2, *u);
+	*t = rs_mod2pi(theta + alpha);
+	*v = rs_mod2pi(*t - phi);
+
+	length_rs = ctx->radcurv * (*t + *v) + *u;
+	return(length_rs);
+}
+
+
+/***********************************************************/
+RS_KERNEL vd ccu_cuc(const rs_context* ctx, vd x, vd y, vd phi, vd rs, vd rc, vd* t, vd* u, vd* v)
+{
+	vd a, b, u1, theta, alpha, length_rs;
+
+	a = x + rs;
+	b = y - rc;
+	if ((fabs(a)<EPS3) && (fabs(b)<EPS3)) return(INFINITY);
+	u1 = sqrt(a*a + b * b);
+	if (u1 > ctx->radcurvmul4) return(INFINITY);
+	theta = rs_atan2(b, a);
+	if (u1>ctx->radcurvmul2)
+	{
+		alpha = rs_acos((u1 / 2 - ctx->radcurv) / ctx->radcurvmul2);
+		*t = rs_mod2pi(MPIDIV2 + theta - alpha);
+		*u = rs_mod2pi(MPI - alpha);
+		*v = rs_mod2pi(phi - *t + 2 * (*u));
+	}
+	else
+	{
+		alpha = rs_acos((u1 / 2 + ctx->radcurv) / (ctx->radcurvmul2));
+		*t = rs_mod2pi(MPIDIV2 + theta + alpha);
+		*u = rs_mod2pi(alpha);
+		*v = rs_mod2pi(phi - *t + 2 * (*u));
+	}
+
+	length_rs = ctx->radcurv * (2 * (*u) + *t + *v);
+	return(length_rs);
+}
+
+
+/***********************************************************/
+RS_KERNEL vd c_cucu_c(const rs_context* ctx, vd x, vd y, vd phi, vd rs, vd rc, vd* t, vd* u, vd* v)
+{
+	vd a, b, u1, theta, alpha, length_rs, va1, va2;
+
+	a = x + rs;
+	b = y - rc;
+	if ((fabs(a)<EPS3) && (fabs(b)<EPS3)) return(INFINITY);
+	u1 = sqrt(a*a + b * b);
+	if (u1 > 6 * ctx->radcurv) return(INFINITY);
+	theta = rs_atan2(b, a);
+	va1 = (5 * ctx->sqradcurv - u1 * u1 / 4) / ctx->sqradcurvmul2;
+	if ((va1 < 0.0) || (va1 > 1.0)) return(INFINITY);
+	*u = rs_acos(va1);
+	va2 = sqrt((1 - va1) * (1 + va1));
+	alpha = rs_asin(ctx->radcurvmul2*va2 / u1);
+	*t = rs_mod2pi(MPIDIV2 + theta + alpha);
+	*v = rs_mod2pi(*t - phi);
+
+	length_rs = ctx->radcurv * (2 * (*u) + *t + *v);
+	return(length_rs);
+}
+
+
+/***********************************************************/
+RS_KERNEL vd c_c2sca(const rs_context* ctx, vd x, vd y, vd phi, vd rs, vd rc, vd* t, vd* u, vd* v)
+{
+	vd a, b, u1, theta, alpha, length_rs;
+
+	a = x - rs;
+	b = y + rc;
+	u1 = sqrt(a*a + b * b);
+	if (u1 < ctx->radcurvmul2) return(INFINITY);
+	theta = rs_atan2(b, a);
+	*u = sqrt(u1*u1 - ctx->sqradcurvmul2) - ctx->radcurvmul2;
+	if (*u < 0.0) return(INFINITY);
+	alpha = rs_atan2(ctx->radcurvmul2, (*u + ctx->radcurvmul2));
+	*t = rs_mod2pi(MPIDIV2 + theta + alpha);
+	*v = rs_mod2pi(*t + MPIDIV2 - phi);
+
+	length_rs = ctx->radcurv * (*t + MPIDIV2 + *v) + *u;
+	return(length_rs);
+}
+
+
+/***********************************************************/
+RS_KERNEL vd c_c2scb(const rs_context* ctx, vd x, vd y, vd phi, vd rs, vd rc, vd* t, vd* u, vd* v)
+{
+	vd a, b, u1, theta, length_rs;
+
+	a = x + rs;
+	b = y - rc;
+	u1 = sqrt(a*a + b * b);
+	if (u1 < ctx->radcurvmul2) return(INFINITY);
+	theta = rs_atan2(b, a);
+	*t = rs_mod2pi(MPIDIV2 + theta);
+	*u = u1 - ctx->radcurvmul2;
+	*v = rs_mod2pi(phi - *t - MPIDIV2);
+
+	length_rs = ctx->radcurv * (*t + MPIDIV2 + *v) + *u;
+	return(length_rs);
+}
+
+
+/***********************************************************/
+RS_KERNEL vd c_c2sc2_c(const rs_context* ctx, vd x, vd y, vd phi, vd rs, vd rc, vd* t, vd* u, vd* v)
+{
+	vd a, b, u1, theta, alpha, length_rs;
+
+	a = x + rs;
+	b = y - rc;
+	u1 = sqrt(a*a + b * b);
+	if (u1 < ctx->radcurvmul4) return(INFINITY);
+	theta = rs_atan2(b, a);
+	*u = sqrt(u1*u1 - ctx->sqradcurvmul2) - ctx->radcurvmul4;
+	if (*u < 0.0) return(INFINITY);
+	alpha = rs_atan2(ctx->radcurvmul2, (*u + ctx->radcurvmul4));
+	*t = rs_mod2pi(MPIDIV2 + theta + alpha);
+	*v = rs_mod2pi(*t - phi);
+
+	length_rs = ctx->radcurv * (*t + MPI + *v) + *u;
+	return(length_rs);
+}
+
+
+/***********************************************************/
+RS_KERNEL vd cc_c(const rs_context* ctx, vd x, vd y, vd phi, vd rs, vd rc, vd* t, vd* u, vd* v)
+{
+	vd a, b, u1, theta, alpha, length_rs, va;
+
+	a = x - rs;
+	b = y + rc;
+	if ((fabs(a)<EPS3) && (fabs(b)<EPS3)) return(INFINITY);
+	u1 = sqrt(a*a + b * b);
+	if (u1>ctx->radcurvmul4) return(INFINITY);
+	theta = rs_atan2(b, a);
+	va = (8 * ctx->sqradcurv - u1 * u1) / (8 * ctx->sqradcurv);
+	*u = rs_acos(va);
+	va = sqrt((1 - va) * (1 + va));
+	if ((fabs(va)<0.001) && (fabs(u1)<0.001)) return(INFINITY);
+	alpha = rs_asin(ctx->radcurvmul2*va / u1);
+	*t = rs_mod2pi(MPIDIV2 - alpha + theta);
+	*v = rs_mod2pi(*t - *u - phi);
+
+	length_rs = ctx->radcurv * (*t + *u + *v);
+	return(length_rs);
+}
+
+
+/***********************************************************/
+RS_KERNEL vd csc2_ca(const rs_context* ctx, vd x, vd y, vd phi, vd rs, vd rc, vd* t, vd* u, vd* v)
+{
+	vd a, b, u1, theta, alpha, length_rs;
+
+	a = x - rs;
+	b = y + rc;
+	u1 = sqrt(a*a + b * b);
+	if (u1 < ctx->radcurvmul2) return(INFINITY);
+	theta = rs_atan2(b, a);
+	*u = sqrt(u1*u1 - ctx->sqradcurvmul2) - ctx->radcurvmul2;
+	if (*u < 0.0) return(INFINITY);
+	alpha = rs_atan2((*u + ctx->radcurvmul2), ctx->radcurvmul2);
+	*t = rs_mod2pi(MPIDIV2 + theta - alpha);
+	*v = rs_mod2pi(*t - MPIDIV2 - phi);
+
+	length_rs = ctx->radcurv * (*t + MPIDIV2 + *v) + *u;
+	return(length_rs);
+}
+
+
+/***********************************************************/
+RS_KERNEL vd csc2_cb(const rs_context* ctx, vd x, vd y, vd phi, vd rs, vd rc, vd* t, vd* u, vd* v)
+{
+	vd a, b, u1, theta, length_rs;
+
+	a = x + rs;
+	b = y - rc;
+	u1 = sqrt(a*a + b * b);
+	if (u1 < ctx->radcurvmul2) return(INFINITY);
+	theta = rs_atan2(b, a);
+	*t = rs_mod2pi(theta);
+	*u = u1 - ctx->radcurvmul2;
+	*v = rs_mod2pi(-*t - MPIDIV2 + phi);
+
+	length_rs = ctx->radcurv * (*t + MPIDIV2 + *v) + *u;
+	return(length_rs);
+}
+
+#endif
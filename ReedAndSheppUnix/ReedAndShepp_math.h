@@ -0,0 +1,185 @@
+// ReedAndShepp_math.h : atan, acos, asin, my_atan2 and mod2pi without branches.
+//
+
+#ifndef REEDANDSHEPP_MATH_H
+#define REEDANDSHEPP_MATH_H
+
+/*
+
+The functions of families of curves spend most of their time in atan,
+acos, asin, my_atan2 and mod2pi. This file computes them with the same
+operations on every input, so that they compile to straight code, and the
+same source serves the scalar scan of ReedAndShepp.c and the vectorized
+one of ReedAndShepp_simd.c.
+
+The file is written with the primitives vd_set1, vd_add, vd_sub, vd_mul,
+vd_div, vd_sqrt, vd_abs, vd_floor, vd_neg, vd_lt, vd_gt, vd_ge, vd_eq,
+vm_and, vm_andnot and vd_sel on the types vd (the numbers) and vm (the
+results of the comparisons). ReedAndShepp_simd.c defines them on the
+vectors of each instruction set before including it. With RS_MATH_SCALAR
+defined, it defines them itself on double and int.
+
+atan is the rational approximation of Cephes, within 2 ulp of the one of
+libm. acos(x) is computed as 2 atan(sqrt((1-x)/(1+x))) and asin(x) as
+atan(x/sqrt(1-x*x)), both within 1e-15 of libm on [-1,1]. rs_mod2pi
+subtracts a multiple of 2 pi found with floor rather than one 2 pi at a
+time, so its cost does not grow with the angle. mod2pi and my_atan2 of
+ReedAndShepp.c are rs_mod2pi and rs_atan2. The lengths of the solver
+agree with the ones computed with libm to about 1e-13, and the curves
+chosen differ only between curves of the same length.
+
+With RS_MATH_LIBM defined as well as RS_MATH_SCALAR, the functions are
+the ones of libm, with the branches of my_atan2 and the loops of mod2pi
+of the first version of ReedAndShepp.c. make check builds the solver
+both ways and checks the above on queries where several curves have the
+same length, see ReedAndShepp_check_ties.c.
+
+*/
+
+#ifdef RS_MATH_SCALAR
+
+#include <math.h>
+
+typedef double vd;
+typedef int vm;
+
+static inline vd vd_set1(double a) { return a; }
+static inline vd vd_add(vd a, vd b) { return a + b; }
+static inline vd vd_sub(vd a, vd b) { return a - b; }
+static inline vd vd_mul(vd a, vd b) { return a * b; }
+static inline vd vd_div(vd a, vd b) { return a / b; }
+static inline vd vd_sqrt(vd a) { return sqrt(a); }
+static inline vd vd_abs(vd a) { return fabs(a); }
+static inline vd vd_floor(vd a) { return floor(a); }
+static inline vd vd_neg(vd a) { return -a; }
+static inline vm vd_lt(vd a, vd b) { return a < b; }
+static inline vm vd_gt(vd a, vd b) { return a > b; }
+static inline vm vd_ge(vd a, vd b) { return a >= b; }
+static inline vm vd_eq(vd a, vd b) { return a == b; }
+static inline vm vm_and(vm a, vm b) { return a & b; }
+static inline vm vm_andnot(vm a, vm b) { return (!a) & b; }
+/* m ? a : b */
+static inline vd vd_sel(vm m, vd a, vd b) { return m ? a : b; }
+
+#endif
+
+
+#if defined(RS_MATH_SCALAR) && defined(RS_MATH_LIBM)
+
+static inline double rs_atan(double x) { return atan(x); }
+static inline double rs_acos(double x) { return acos(x); }
+static inline double rs_asin(double x) { return asin(x); }
+
+
+/***********************************************************/
+static inline double rs_atan2(double y, double x)
+{
+	double a;
+	if ((x == 0.0) && (y == 0.0)) return 0.0;
+	if (x == 0.0)
+		if (y > 0) return MPIDIV2;
+		else return -MPIDIV2;
+	a = atan(y / x);
+	if (a > 0.0)
+		if (x > 0) return a;
+		else return (a + MPI);
+	else
+		if (x > 0) return (a + MPIMUL2);
+		else return (a + MPI);
+}
+
+
+/***********************************************************/
+static inline double rs_mod2pi(double angle)
+{
+	while (angle < 0.0) angle = angle + MPIMUL2;
+	while (angle >= MPIMUL2) angle = angle - MPIMUL2;
+	return angle;
+}
+
+#else
+
+/***********************************************************/
+/* atan, from Cephes */
+static inline vd rs_atan(vd x)
+{
+	vd a, z, p, q, y0, more, r;
+	vm big, mid;
+
+	a = vd_abs(x);
+	big = vd_gt(a, vd_set1(2.41421356237309504880));
+	mid = vm_andnot(big, vd_gt(a, vd_set1(0.66)));
+
+	z = vd_sel(big, vd_div(vd_set1(-1.0), a),
+		vd_sel(mid, vd_div(vd_sub(a, vd_set1(1.0)), vd_add(a, vd_set1(1.0))), a));
+	y0 = vd_sel(big, vd_set1(1.57079632679489661923), vd_sel(mid, vd_set1(0.78539816339744830962), vd_set1(0.0)));
+	more = vd_sel(big, vd_set1(6.123233995736765886130E-17), vd_sel(mid, vd_set1(3.061616997868382943065E-17), vd_set1(0.0)));
+
+	r = vd_mul(z, z);
+	p = vd_add(vd_mul(vd_set1(-8.750608600031904122785E-1), r), vd_set1(-1.615753718733365076637E1));
+	p = vd_add(vd_mul(p, r), vd_set1(-7.500855792314704667340E1));
+	p = vd_add(vd_mul(p, r), vd_set1(-1.228866684490136173410E2));
+	p = vd_add(vd_mul(p, r), vd_set1(-6.485021904942025371773E1));
+	q = vd_add(r, vd_set1(2.485846490142306297962E1));
+	q = vd_add(vd_mul(q, r), vd_set1(1.650270098316988542046E2));
+	q = vd_add(vd_mul(q, r), vd_set1(4.328810604912902668951E2));
+	q = vd_add(vd_mul(q, r), vd_set1(4.853903996359136964868E2));
+	q = vd_add(vd_mul(q, r), vd_set1(1.945506571482613964425E2));
+
+	r = vd_add(vd_mul(z, vd_div(vd_mul(r, p), q)), z);
+	r = vd_add(y0, vd_add(r, more));
+	return(vd_sel(vd_lt(x, vd_set1(0.0)), vd_neg(r), r));
+}
+
+
+/***********************************************************/
+static inline vd rs_acos(vd x)
+{
+	vd one = vd_set1(1.0);
+	vd r = rs_atan(vd_sqrt(vd_div(vd_sub(one, x), vd_add(one, x))));
+	return(vd_add(r, r));
+}
+
+
+/***********************************************************/
+static inline vd rs_asin(vd x)
+{
+	vd one = vd_set1(1.0);
+	return(rs_atan(vd_div(x, vd_sqrt(vd_mul(vd_sub(one, x), vd_add(one, x))))));
+}
+
+
+/***********************************************************/
+/* same as my_atan2 */
+static inline vd rs_atan2(vd y, vd x)
+{
+	vd zero = vd_set1(0.0);
+	vd a, r, r0;
+	vm xpos;
+
+	a = rs_atan(vd_div(y, x));
+	xpos = vd_gt(x, zero);
+	r = vd_sel(vd_gt(a, zero),
+		vd_sel(xpos, a, vd_add(a, vd_set1(MPI))),
+		vd_sel(xpos, vd_add(a, vd_set1(MPIMUL2)), vd_add(a, vd_set1(MPI))));
+	r0 = vd_sel(vd_eq(y, zero), zero, vd_sel(vd_gt(y, zero), vd_set1(MPIDIV2), vd_set1(-MPIDIV2)));
+	return(vd_sel(vd_eq(x, zero), r0, r));
+}
+
+
+/***********************************************************/
+/* angle in [0, 2 pi) */
+static inline vd rs_mod2pi(vd angle)
+{
+	vd twopi = vd_set1(MPIMUL2);
+	vd zero = vd_set1(0.0);
+
+	angle = vd_sub(angle, vd_mul(twopi, vd_floor(vd_mul(angle, vd_set1(1.0 / MPIMUL2)))));
+	angle = vd_sel(vd_ge(angle, twopi), vd_sub(angle, twopi), angle);
+	angle = vd_sel(vd_lt(angle, zero), vd_add(angle, twopi), angle);
+	return(angle);
+}
+
+#endif
+
+#endif
@@ -0,0 +1,202 @@
+// ReedAndShepp_matrix.c : matrices of lengths of RS curves, on several threads.
+//
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <pthread.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "ReedAndShepp.h"
+#include "ReedAndShepp_internal.h"
+
+/*
+
+reed_shepp_matrix splits the matrix in tiles of RS_MATRIX_TILE x
+RS_MATRIX_TILE lengths, small enough for the configurations and lengths
+of a tile to stay in the cache. The threads take the tiles one after the
+other from a shared counter, so a thread that is done with its tile takes
+the next one left, whatever the others do. Each row of a tile is computed
+by reed_shepp_batch_ctx into a buffer of the thread, then copied to the
+matrix with streaming stores, which do not load the lines of the matrix
+in the cache only to overwrite them.
+
+The calling thread works too, and is the only one to call progress.
+
+*/
+
+#define RS_MATRIX_TILE 64
+
+typedef struct
+{
+	const rs_context* ctx;
+	int n, m, band;
+	const double *x1, *y1, *t1, *x2, *y2, *t2;
+	double* out;
+	int ntilesj;
+	long long ntiles;
+	long long next;		/* next tile to compute */
+	long long done;		/* tiles computed */
+} rs_matrix_job;
+
+
+/***********************************************************/
+static void rs_store_stream(double* dst, const double* src, int n)
+{
+	int k;
+
+	k = 0;
+#ifdef __SSE2__
+	if (((uintptr_t)dst & 15) != 0)
+	{
+		dst[0] = src[0];
+		k = 1;
+	}
+	for (; k + 2 <= n; k += 2) _mm_stream_pd(dst + k, _mm_loadu_pd(src + k));
+#endif
+	for (; k < n; k++) dst[k] = src[k];
+}
+
+
+/***********************************************************/
+static void rs_matrix_tile(rs_matrix_job* job, long long tile)
+{
+	double x1[RS_MATRIX_TILE], y1[RS_MATRIX_TILE], t1[RS_MATRIX_TILE];
+	double length[RS_MATRIX_TILE], tr[RS_MATRIX_TILE], ur[RS_MATRIX_TILE], vr[RS_MATRIX_TILE];
+	int numero[RS_MATRIX_TILE];
+	int i0, i1, j0, j1, i, k, jb, je;
+
+	i0 = (int)(tile / job->ntilesj) * RS_MATRIX_TILE;
+	j0 = (int)(tile % job->ntilesj) * RS_MATRIX_TILE;
+	i1 = (i0 + RS_MATRIX_TILE < job->n) ? i0 + RS_MATRIX_TILE : job->n;
+	j1 = (j0 + RS_MATRIX_TILE < job->m) ? j0 + RS_MATRIX_TILE : job->m;
+
+	for (i = i0; i < i1; i++)
+	{
+		/* columns of the row i inside the band */
+		jb = j0;
+		je = j1;
+		if ((job->band == RS_MATRIX_UPPER) && (jb < i)) jb = i;
+		if ((job->band == RS_MATRIX_LOWER) && (je > i + 1)) je = i + 1;
+		if (jb >= je) continue;
+
+		for (k = 0; k < je - jb; k++)
+		{
+			x1[k] = job->x1[i];
+			y1[k] = job->y1[i];
+			t1[k] = job->t1[i];
+		}
+		reed_shepp_batch_ctx(job->ctx, je - jb, x1, y1, t1, job->x2 + jb, job->y2 + jb, job->t2 + jb,
+			length, numero, tr, ur, vr);
+		rs_store_stream(job->out + (size_t)i * job->m + jb, length, je - jb);
+	}
+}
+
+
+/***********************************************************/
+/*
+Returns 1 when the tile has some lengths inside the band.
+*/
+static int rs_matrix_in_band(const rs_matrix_job* job, long long tile)
+{
+	int i0, j0;
+
+	i0 = (int)(tile / job->ntilesj) * RS_MATRIX_TILE;
+	j0 = (int)(tile % job->ntilesj) * RS_MATRIX_TILE;
+	if (job->band == RS_MATRIX_UPPER) return(j0 + RS_MATRIX_TILE > i0);
+	if (job->band == RS_MATRIX_LOWER) return(j0 < i0 + RS_MATRIX_TILE);
+	return(1);
+}
+
+
+/***********************************************************/
+static void* rs_matrix_worker(void* arg)
+{
+	rs_matrix_job* job;
+	long long tile;
+
+	job = (rs_matrix_job*)arg;
+	while ((tile = __atomic_fetch_add(&job->next, 1, __ATOMIC_RELAXED)) < job->ntiles)
+	{
+		if (rs_matrix_in_band(job, tile)) rs_matrix_tile(job, tile);
+		__atomic_fetch_add(&job->done, 1, __ATOMIC_RELAXED);
+	}
+#ifdef __SSE2__
+	_mm_sfence();
+#endif
+	return(NULL);
+}
+
+
+/***********************************************************/
+EXPORT
+int reed_shepp_matrix_ctx(const rs_context* ctx, int n, const double* x1, const double* y1, const double* t1,
+	int m, const double* x2, const double* y2, const double* t2, int band, int nthreads, double* out,
+	rs_progress_fn progress, void* user)
+{
+	rs_matrix_job job;
+	pthread_t* threads;
+	long long tile;
+	int i, started;
+
+	if ((n < 0) || (m < 0)) return(0);
+
+	job.ctx = ctx;
+	job.n = n;
+	job.m = m;
+	job.band = band;
+	job.x1 = x1;
+	job.y1 = y1;
+	job.t1 = t1;
+	job.x2 = x2;
+	job.y2 = y2;
+	job.t2 = t2;
+	job.out = out;
+	job.ntilesj = (m + RS_MATRIX_TILE - 1) / RS_MATRIX_TILE;
+	job.ntiles = (long long)((n + RS_MATRIX_TILE - 1) / RS_MATRIX_TILE) * job.ntilesj;
+	job.next = 0;
+	job.done = 0;
+
+	if (nthreads <= 0) nthreads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+	if (nthreads <= 0) nthreads = 1;
+	if (nthreads > job.ntiles) nthreads = (job.ntiles > 0) ? (int)job.ntiles : 1;
+
+	threads = (pthread_t*)malloc(nthreads * sizeof(pthread_t));
+	if (threads == NULL) return(0);
+
+	/* the calling thread is the last worker */
+	started = 0;
+	for (i = 0; i < nthreads - 1; i++)
+	{
+		if (pthread_create(&threads[i], NULL, rs_matrix_worker, &job) != 0) break;
+		started++;
+	}
+
+	while ((tile = __atomic_fetch_add(&job.next, 1, __ATOMIC_RELAXED)) < job.ntiles)
+	{
+		if (rs_matrix_in_band(&job, tile)) rs_matrix_tile(&job, tile);
+		__atomic_fetch_add(&job.done, 1, __ATOMIC_RELAXED);
+		if (progress != NULL) progress(user, __atomic_load_n(&job.done, __ATOMIC_RELAXED), job.ntiles);
+	}
+#ifdef __SSE2__
+	_mm_sfence();
+#endif
+
+	for (i = 0; i < started; i++) pthread_join(threads[i], NULL);
+	free(threads);
+
+	if (progress != NULL) progress(user, job.ntiles, job.ntiles);
+	return(1);
+}
+
+
+/***********************************************************/
+EXPORT
+int reed_shepp_matrix(int n, const double* x1, const double* y1, const double* t1,
+	int m, const double* x2, const double* y2, const double* t2, int band, int nthreads, double* out,
+	rs_progress_fn progress, void* user)
+{
+	return(reed_shepp_matrix_ctx(&rs_default, n, x1, y1, t1, m, x2, y2, t2, band, nthreads, out, progress, user));
+}
@@ -0,0 +1,329 @@
+// ReedAndShepp_path.c : RS curves as lists of segments, without discretization.
+//
+
+#include <math.h>
+#include <limits.h>
+
+#include "ReedAndShepp.h"
+#include "ReedAndShepp_internal.h"
+
+/*
+
+rs_segment_pose moves the pose (x,y,theta) along a segment of type type
+and direction direction by the length s. On an arc toward the right the
+heading decreases when moving forward, and the center of the circle is
+on the right of the robot, at a distance radcurv; it is the opposite
+toward the left.
+
+*/
+
+void rs_segment_pose(double radcurv, int type, int direction, double s, double* x, double* y, double* theta)
+{
+	double cx, cy, a;
+
+	switch (type)
+	{
+	case RS_RIGHT:
+		cx = *x + radcurv * sin(*theta);
+		cy = *y - radcurv * cos(*theta);
+		a = *theta - direction * s / radcurv;
+		*x = cx - radcurv * sin(a);
+		*y = cy + radcurv * cos(a);
+		*theta = a;
+		break;
+
+	case RS_LEFT:
+		cx = *x - radcurv * sin(*theta);
+		cy = *y + radcurv * cos(*theta);
+		a = *theta + direction * s / radcurv;
+		*x = cx + radcurv * sin(a);
+		*y = cy - radcurv * cos(a);
+		*theta = a;
+		break;
+
+	case RS_STRAIGHT:
+		*x = *x + direction * s * cos(*theta);
+		*y = *y + direction * s * sin(*theta);
+		break;
+	}
+}
+
+
+/***********************************************************/
+/*
+Appends a segment to path, merging it with the last one when they have
+the same type and direction. Segments shorter than EPS4 * radcurv are
+dropped. Returns 0 when the path is full.
+*/
+static int rs_path_append(rs_path* path, int type, int direction, double length)
+{
+	rs_path_segment* last;
+
+	if (length < EPS4 * path->radcurv) return(1);
+
+	if (path->nsegments > 0)
+	{
+		last = &path->segments[path->nsegments - 1];
+		if ((last->type == type) && (last->direction == direction))
+		{
+			last->length = last->length + length;
+			return(1);
+		}
+	}
+
+	if (path->nsegments == RS_PATH_MAX_SEGMENTS) return(0);
+	path->segments[path->nsegments].type = type;
+	path->segments[path->nsegments].direction = direction;
+	path->segments[path->nsegments].length = length;
+	path->nsegments++;
+	return(1);
+}
+
+
+/***********************************************************/
+EXPORT
+int rs_path_from_word_ctx(const rs_context* ctx, rs_path* path, int num, double t, double u, double v, double x1, double y1, double t1)
+{
+	const rs_segment* seg;
+	double lengths[4], l;
+	int i;
+
+	path->x = x1;
+	path->y = y1;
+	path->theta = t1;
+	path->radcurv = ctx->radcurv;
+	path->nsegments = 0;
+	if ((num < 1) || (num > 48)) return(0);
+
+	lengths[RS_T] = t;
+	lengths[RS_U] = u;
+	lengths[RS_V] = v;
+	lengths[RS_HALFPI] = MPIDIV2;
+
+	for (i = 0; (i < RS_MAX_SEGMENTS) && (rs_words[num - 1][i].type != 0); i++)
+	{
+		seg = &rs_words[num - 1][i];
+		l = lengths[seg->length];
+		if (seg->type != RS_STRAIGHT) l = l * ctx->radcurv;
+		rs_path_append(path, seg->type, seg->orientation, l);
+	}
+
+	return(1);
+}
+
+
+/***********************************************************/
+EXPORT
+int rs_path_from_word(rs_path* path, int num, double t, double u, double v, double x1, double y1, double t1)
+{
+	return(rs_path_from_word_ctx(&rs_default, path, num, t, u, v, x1, y1, t1));
+}
+
+
+/***********************************************************/
+EXPORT
+double reed_shepp_path_ctx(const rs_context* ctx, double x1, double y1, double t1, double x2, double y2, double t2, rs_path* path)
+{
+	double length, t, u, v;
+	int numero;
+
+	length = reed_shepp_ctx(ctx, x1, y1, t1, x2, y2, t2, &numero, &t, &u, &v);
+	rs_path_from_word_ctx(ctx, path, numero, t, u, v, x1, y1, t1);
+	return(length);
+}
+
+
+/***********************************************************/
+EXPORT
+double reed_shepp_path(double x1, double y1, double t1, double x2, double y2, double t2, rs_path* path)
+{
+	return(reed_shepp_path_ctx(&rs_default, x1, y1, t1, x2, y2, t2, path));
+}
+
+
+/***********************************************************/
+EXPORT
+double rs_path_length(const rs_path* path)
+{
+	double length;
+	int i;
+
+	length = 0;
+	for (i = 0; i < path->nsegments; i++) length = length + path->segments[i].length;
+	return(length);
+}
+
+
+/***********************************************************/
+EXPORT
+void rs_path_eval(const rs_path* path, double s, double* x, double* y, double* theta)
+{
+	const rs_path_segment* seg;
+	int i;
+
+	*x = path->x;
+	*y = path->y;
+	*theta = path->theta;
+
+	if (s < 0) s = 0;
+	for (i = 0; i < path->nsegments; i++)
+	{
+		seg = &path->segments[i];
+		if (s <= seg->length)
+		{
+			rs_segment_pose(path->radcurv, seg->type, seg->direction, s, x, y, theta);
+			break;
+		}
+		rs_segment_pose(path->radcurv, seg->type, seg->direction, seg->length, x, y, theta);
+		s = s - seg->length;
+	}
+
+	*theta = mod2pi(*theta);
+}
+
+
+/***********************************************************/
+EXPORT
+int rs_path_sample(const rs_path* path, double step, int capacity, double* pathx, double* pathy, double* patht)
+{
+	const rs_path_segment* seg;
+	double length, s, start, x, y, theta, sx, sy, st;
+	int i, k, n;
+
+	length = rs_path_length(path);
+	if (!(step > 0) || !(length / step < INT_MAX - 2)) return(0);
+	n = (int)(length / step) + 1;
+	if (length - (n - 1) * step > EPS4 * path->radcurv) n++;
+
+	/* start of the segment i, which begins at the length start */
+	i = 0;
+	start = 0;
+	sx = path->x;
+	sy = path->y;
+	st = path->theta;
+
+	for (k = 0; (k < n) && (k < capacity); k++)
+	{
+		s = (k < n - 1) ? k * step : length;
+		while ((i < path->nsegments - 1) && (s > start + path->segments[i].length))
+		{
+			seg = &path->segments[i];
+			rs_segment_pose(path->radcurv, seg->type, seg->direction, seg->length, &sx, &sy, &st);
+			start = start + seg->length;
+			i++;
+		}
+
+		x = sx;
+		y = sy;
+		theta = st;
+		if (path->nsegments > 0)
+		{
+			seg = &path->segments[i];
+			rs_segment_pose(path->radcurv, seg->type, seg->direction, s - start, &x, &y, &theta);
+		}
+		pathx[k] = x;
+		pathy[k] = y;
+		patht[k] = mod2pi(theta);
+	}
+
+	return(n);
+}
+
+
+/***********************************************************/
+EXPORT
+void rs_path_reverse(const rs_path* path, rs_path* reversed)
+{
+	rs_path copy;
+	int i;
+
+	copy = *path;
+	rs_path_eval(&copy, rs_path_length(&copy), &reversed->x, &reversed->y, &reversed->theta);
+	reversed->radcurv = copy.radcurv;
+	reversed->nsegments = copy.nsegments;
+	for (i = 0; i < copy.nsegments; i++)
+	{
+		reversed->segments[i].type = copy.segments[copy.nsegments - 1 - i].type;
+		reversed->segments[i].direction = -copy.segments[copy.nsegments - 1 - i].direction;
+		reversed->segments[i].length = copy.segments[copy.nsegments - 1 - i].length;
+	}
+}
+
+
+/***********************************************************/
+EXPORT
+void rs_path_split(const rs_path* path, double s, rs_path* first, rs_path* second)
+{
+	rs_path copy;
+	const rs_path_segment* seg;
+	int i;
+
+	copy = *path;
+	first->x = copy.x;
+	first->y = copy.y;
+	first->theta = copy.theta;
+	first->radcurv = copy.radcurv;
+	first->nsegments = 0;
+	rs_path_eval(&copy, s, &second->x, &second->y, &second->theta);
+	second->radcurv = copy.radcurv;
+	second->nsegments = 0;
+
+	if (s < 0) s = 0;
+	for (i = 0; i < copy.nsegments; i++)
+	{
+		seg = &copy.segments[i];
+		if (s >= seg->length)
+		{
+			rs_path_append(first, seg->type, seg->direction, seg->length);
+			s = s - seg->length;
+		}
+		else
+		{
+			rs_path_append(first, seg->type, seg->direction, s);
+			rs_path_append(second, seg->type, seg->direction, seg->length - s);
+			s = 0;
+		}
+	}
+}
+
+
+/***********************************************************/
+EXPORT
+int rs_path_concat(const rs_path* a, const rs_path* b, rs_path* path)
+{
+	rs_path result;
+	int i;
+
+	if (a->radcurv != b->radcurv) return(0);
+
+	result = *a;
+	for (i = 0; i < b->nsegments; i++)
+		if (!rs_path_append(&result, b->segments[i].type, b->segments[i].direction, b->segments[i].length)) return(0);
+
+	*path = result;
+	return(1);
+}
+
+
+/***********************************************************/
+EXPORT
+int rs_pose_at_ctx(const rs_context* ctx, int num, double t, double u, double v, double x1, double y1, double t1, double s,
+	double* x, double* y, double* theta)
+{
+	rs_path path;
+	int known;
+
+	known = rs_path_from_word_ctx(ctx, &path, num, t, u, v, x1, y1, t1);
+	rs_path_eval(&path, s, x, y, theta);
+	if (!known) *theta = t1;
+	return(known);
+}
+
+
+/***********************************************************/
+EXPORT
+int rs_pose_at(int num, double t, double u, double v, double x1, double y1, double t1, double s,
+	double* x, double* y, double* theta)
+{
+	return(rs_pose_at_ctx(&rs_default, num, t, u, v, x1, y1, t1, s, x, y, theta));
+}
@@ -0,0 +1,618 @@
+// ReedAndShepp_simd.c : vectorized scan of the RS curves (SSE4.2, AVX2 and AVX-512).
+//
+
+#include <math.h>
+
+#include "ReedAndShepp_internal.h"
+
+#if defined(__AVX512F__) || defined(__AVX2__) || defined(__SSE4_2__)
+
+#include <immintrin.h>
+
+/*
+
+The 48 RS curves are the 12 families c_c_c through csc2_cb, each one
+evaluated for the four symmetric increments (x,y,phi), (-x,y,-phi),
+(x,-y,-phi) and (-x,-y,phi). Here every lane of a vector holds one of
+these four increments (a "reflection") of one query, so that a family is
+evaluated for all its reflections in a single pass:
+
+	lane l  ->  query l / 4, reflection l % 4
+
+With AVX2 a vector holds the four reflections of a query, with AVX-512
+it holds those of two queries and with SSE4.2 half of them. The families are written without
+branches: the cases where the scalar functions return INFINITY are
+computed as masks and the lanes are set to INFINITY at the end. Each
+lane keeps the shortest curve found over the 12 families, and the four
+lanes of a query are then reduced to the shortest of its 48 curves,
+ties going to the smallest curve number as in the scalar scan.
+
+acos, asin, atan, my_atan2 and mod2pi are the ones of ReedAndShepp_math.h,
+shared with the scalar scan, and sin(acos(x)) is computed as sqrt(1-x*x).
+The results agree with the scalar scan to about 1e-12.
+
+When RS_SIMD_FLOAT is defined, the same code is compiled in single
+precision as rs_solve_f_<isa>, for reed_shepp_batch_f: a vector then holds
+twice as many lanes, the four reflections of one query with SSE4.2, of two
+with AVX2 and of four with AVX-512.
+
+*/
+
+/***********************************************************/
+/* vector primitives */
+
+#if defined(RS_SIMD_FLOAT)
+
+typedef float rs_real;
+#define RS_SIN sinf
+#define RS_COS cosf
+
+#if defined(__AVX512F__)
+
+#define RS_W 16
+#define RS_SOLVE rs_solve_f_avx512
+typedef __m512 vd;
+typedef __mmask16 vm;
+
+static inline vd vd_set1(double a) { return _mm512_set1_ps((float)a); }
+static inline vd vd_load(const float* p) { return _mm512_load_ps(p); }
+static inline void vd_store(float* p, vd a) { _mm512_store_ps(p, a); }
+static inline vd vd_add(vd a, vd b) { return _mm512_add_ps(a, b); }
+static inline vd vd_sub(vd a, vd b) { return _mm512_sub_ps(a, b); }
+static inline vd vd_mul(vd a, vd b) { return _mm512_mul_ps(a, b); }
+static inline vd vd_div(vd a, vd b) { return _mm512_div_ps(a, b); }
+static inline vd vd_sqrt(vd a) { return _mm512_sqrt_ps(a); }
+static inline vd vd_abs(vd a) { return _mm512_abs_ps(a); }
+static inline vd vd_floor(vd a) { return _mm512_roundscale_ps(a, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC); }
+static inline vd vd_neg(vd a) { return _mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(a), _mm512_set1_epi32((int)0x80000000))); }
+static inline vm vd_lt(vd a, vd b) { return _mm512_cmp_ps_mask(a, b, _CMP_LT_OQ); }
+static inline vm vd_gt(vd a, vd b) { return _mm512_cmp_ps_mask(a, b, _CMP_GT_OQ); }
+static inline vm vd_ge(vd a, vd b) { return _mm512_cmp_ps_mask(a, b, _CMP_GE_OQ); }
+static inline vm vd_eq(vd a, vd b) { return _mm512_cmp_ps_mask(a, b, _CMP_EQ_OQ); }
+static inline vm vm_and(vm a, vm b) { return a & b; }
+static inline vm vm_or(vm a, vm b) { return a | b; }
+static inline vm vm_andnot(vm a, vm b) { return (vm)(~a & b); }
+/* m ? a : b */
+static inline vd vd_sel(vm m, vd a, vd b) { return _mm512_mask_blend_ps(m, b, a); }
+
+#elif defined(__AVX2__)
+
+#define RS_W 8
+#define RS_SOLVE rs_solve_f_avx2
+typedef __m256 vd;
+typedef __m256 vm;
+
+static inline vd vd_set1(double a) { return _mm256_set1_ps((float)a); }
+static inline vd vd_load(const float* p) { return _mm256_load_ps(p); }
+static inline void vd_store(float* p, vd a) { _mm256_store_ps(p, a); }
+static inline vd vd_add(vd a, vd b) { return _mm256_add_ps(a, b); }
+static inline vd vd_sub(vd a, vd b) { return _mm256_sub_ps(a, b); }
+static inline vd vd_mul(vd a, vd b) { return _mm256_mul_ps(a, b); }
+static inline vd vd_div(vd a, vd b) { return _mm256_div_ps(a, b); }
+static inline vd vd_sqrt(vd a) { return _mm256_sqrt_ps(a); }
+static inline vd vd_abs(vd a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+static inline vd vd_floor(vd a) { return _mm256_floor_ps(a); }
+static inline vd vd_neg(vd a) { return _mm256_xor_ps(a, _mm256_set1_ps(-0.0f)); }
+static inline vm vd_lt(vd a, vd b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+static inline vm vd_gt(vd a, vd b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+static inline vm vd_ge(vd a, vd b) { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+static inline vm vd_eq(vd a, vd b) { return _mm256_cmp_ps(a, b, _CMP_EQ_OQ); }
+static inline vm vm_and(vm a, vm b) { return _mm256_and_ps(a, b); }
+static inline vm vm_or(vm a, vm b) { return _mm256_or_ps(a, b); }
+static inline vm vm_andnot(vm a, vm b) { return _mm256_andnot_ps(a, b); }
+/* m ? a : b */
+static inline vd vd_sel(vm m, vd a, vd b) { return _mm256_blendv_ps(b, a, m); }
+
+#else
+
+#define RS_W 4
+#define RS_SOLVE rs_solve_f_sse42
+typedef __m128 vd;
+typedef __m128 vm;
+
+static inline vd vd_set1(double a) { return _mm_set1_ps((float)a); }
+static inline vd vd_load(const float* p) { return _mm_load_ps(p); }
+static inline void vd_store(float* p, vd a) { _mm_store_ps(p, a); }
+static inline vd vd_add(vd a, vd b) { return _mm_add_ps(a, b); }
+static inline vd vd_sub(vd a, vd b) { return _mm_sub_ps(a, b); }
+static inline vd vd_mul(vd a, vd b) { return _mm_mul_ps(a, b); }
+static inline vd vd_div(vd a, vd b) { return _mm_div_ps(a, b); }
+static inline vd vd_sqrt(vd a) { return _mm_sqrt_ps(a); }
+static inline vd vd_abs(vd a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+static inline vd vd_floor(vd a) { return _mm_floor_ps(a); }
+static inline vd vd_neg(vd a) { return _mm_xor_ps(a, _mm_set1_ps(-0.0f)); }
+static inline vm vd_lt(vd a, vd b) { return _mm_cmplt_ps(a, b); }
+static inline vm vd_gt(vd a, vd b) { return _mm_cmpgt_ps(a, b); }
+static inline vm vd_ge(vd a, vd b) { return _mm_cmpge_ps(a, b); }
+static inline vm vd_eq(vd a, vd b) { return _mm_cmpeq_ps(a, b); }
+static inline vm vm_and(vm a, vm b) { return _mm_and_ps(a, b); }
+static inline vm vm_or(vm a, vm b) { return _mm_or_ps(a, b); }
+static inline vm vm_andnot(vm a, vm b) { return _mm_andnot_ps(a, b); }
+/* m ? a : b */
+static inline vd vd_sel(vm m, vd a, vd b) { return _mm_blendv_ps(b, a, m); }
+
+#endif
+
+#else
+
+typedef double rs_real;
+#define RS_SIN sin
+#define RS_COS cos
+
+#if defined(__AVX512F__)
+
+#define RS_W 8
+#define RS_SOLVE rs_solve_avx512
+typedef __m512d vd;
+typedef __mmask8 vm;
+
+static inline vd vd_set1(double a) { return _mm512_set1_pd(a); }
+static inline vd vd_load(const double* p) { return _mm512_load_pd(p); }
+static inline void vd_store(double* p, vd a) { _mm512_store_pd(p, a); }
+static inline vd vd_add(vd a, vd b) { return _mm512_add_pd(a, b); }
+static inline vd vd_sub(vd a, vd b) { return _mm512_sub_pd(a, b); }
+static inline vd vd_mul(vd a, vd b) { return _mm512_mul_pd(a, b); }
+static inline vd vd_div(vd a, vd b) { return _mm512_div_pd(a, b); }
+static inline vd vd_sqrt(vd a) { return _mm512_sqrt_pd(a); }
+static inline vd vd_abs(vd a) { return _mm512_abs_pd(a); }
+static inline vd vd_floor(vd a) { return _mm512_roundscale_pd(a, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC); }
+static inline vd vd_neg(vd a) { return _mm512_castsi512_pd(_mm512_xor_si512(_mm512_castpd_si512(a), _mm512_set1_epi64(0x8000000000000000LL))); }
+static inline vm vd_lt(vd a, vd b) { return _mm512_cmp_pd_mask(a, b, _CMP_LT_OQ); }
+static inline vm vd_gt(vd a, vd b) { return _mm512_cmp_pd_mask(a, b, _CMP_GT_OQ); }
+static inline vm vd_ge(vd a, vd b) { return _mm512_cmp_pd_mask(a, b, _CMP_GE_OQ); }
+static inline vm vd_eq(vd a, vd b) { return _mm512_cmp_pd_mask(a, b, _CMP_EQ_OQ); }
+static inline vm vm_and(vm a, vm b) { return a & b; }
+static inline vm vm_or(vm a, vm b) { return a | b; }
+static inline vm vm_andnot(vm a, vm b) { return (vm)(~a & b); }
+/* m ? a : b */
+static inline vd vd_sel(vm m, vd a, vd b) { return _mm512_mask_blend_pd(m, b, a); }
+
+#elif defined(__AVX2__)
+
+#define RS_W 4
+#define RS_SOLVE rs_solve_avx2
+typedef __m256d vd;
+typedef __m256d vm;
+
+static inline vd vd_set1(double a) { return _mm256_set1_pd(a); }
+static inline vd vd_load(const double* p) { return _mm256_load_pd(p); }
+static inline void vd_store(double* p, vd a) { _mm256_store_pd(p, a); }
+static inline vd vd_add(vd a, vd b) { return _mm256_add_pd(a, b); }
+static inline vd vd_sub(vd a, vd b) { return _mm256_sub_pd(a, b); }
+static inline vd vd_mul(vd a, vd b) { return _mm256_mul_pd(a, b); }
+static inline vd vd_div(vd a, vd b) { return _mm256_div_pd(a, b); }
+static inline vd vd_sqrt(vd a) { return _mm256_sqrt_pd(a); }
+static inline vd vd_abs(vd a) { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), a); }
+static inline vd vd_floor(vd a) { return _mm256_floor_pd(a); }
+static inline vd vd_neg(vd a) { return _mm256_xor_pd(a, _mm256_set1_pd(-0.0)); }
+static inline vm vd_lt(vd a, vd b) { return _mm256_cmp_pd(a, b, _CMP_LT_OQ); }
+static inline vm vd_gt(vd a, vd b) { return _mm256_cmp_pd(a, b, _CMP_GT_OQ); }
+static inline vm vd_ge(vd a, vd b) { return _mm256_cmp_pd(a, b, _CMP_GE_OQ); }
+static inline vm vd_eq(vd a, vd b) { return _mm256_cmp_pd(a, b, _CMP_EQ_OQ); }
+static inline vm vm_and(vm a, vm b) { return _mm256_and_pd(a, b); }
+static inline vm vm_or(vm a, vm b) { return _mm256_or_pd(a, b); }
+static inline vm vm_andnot(vm a, vm b) { return _mm256_andnot_pd(a, b); }
+/* m ? a : b */
+static inline vd vd_sel(vm m, vd a, vd b) { return _mm256_blendv_pd(b, a, m); }
+
+#else
+
+#define RS_W 2
+#define RS_SOLVE rs_solve_sse42
+typedef __m128d vd;
+typedef __m128d vm;
+
+static inline vd vd_set1(double a) { return _mm_set1_pd(a); }
+static inline vd vd_load(const double* p) { return _mm_load_pd(p); }
+static inline void vd_store(double* p, vd a) { _mm_store_pd(p, a); }
+static inline vd vd_add(vd a, vd b) { return _mm_add_pd(a, b); }
+static inline vd vd_sub(vd a, vd b) { return _mm_sub_pd(a, b); }
+static inline vd vd_mul(vd a, vd b) { return _mm_mul_pd(a, b); }
+static inline vd vd_div(vd a, vd b) { return _mm_div_pd(a, b); }
+static inline vd vd_sqrt(vd a) { return _mm_sqrt_pd(a); }
+static inline vd vd_abs(vd a) { return _mm_andnot_pd(_mm_set1_pd(-0.0), a); }
+static inline vd vd_floor(vd a) { return _mm_floor_pd(a); }
+static inline vd vd_neg(vd a) { return _mm_xor_pd(a, _mm_set1_pd(-0.0)); }
+static inline vm vd_lt(vd a, vd b) { return _mm_cmplt_pd(a, b); }
+static inline vm vd_gt(vd a, vd b) { return _mm_cmpgt_pd(a, b); }
+static inline vm vd_ge(vd a, vd b) { return _mm_cmpge_pd(a, b); }
+static inline vm vd_eq(vd a, vd b) { return _mm_cmpeq_pd(a, b); }
+static inline vm vm_and(vm a, vm b) { return _mm_and_pd(a, b); }
+static inline vm vm_or(vm a, vm b) { return _mm_or_pd(a, b); }
+static inline vm vm_andnot(vm a, vm b) { return _mm_andnot_pd(a, b); }
+/* m ? a : b */
+static inline vd vd_sel(vm m, vd a, vd b) { return _mm_blendv_pd(b, a, m); }
+
+#endif
+
+#endif
+
+#define RS_ALIGN __attribute__((aligned(64)))
+
+#include "ReedAndShepp_math.h"
+
+
+/***********************************************************/
+/*
+Radius dependent constants, broadcast once per call of RS_SOLVE.
+*/
+typedef struct
+{
+	vd r, r2, r4, sqr, sqr2;
+} vradcurv;
+
+#define RS_VINF vd_set1(INFINITY)
+
+/* |a| < EPS3 and |b| < EPS3 */
+static inline vm vnear0(vd a, vd b)
+{
+	vd eps = vd_set1(EPS3);
+	return(vm_and(vd_lt(vd_abs(a), eps), vd_lt(vd_abs(b), eps)));
+}
+
+
+/***********************************************************/
+static inline vd vc_c_c(const vradcurv* k, vd x, vd y, vd phi, vd rs, vd rc, vd* t, vd* u, vd* v)
+{
+	vd a, b, u1, theta, alpha;
+	vm bad;
+
+	a = vd_sub(x, rs);
+	b = vd_add(y, rc);
+	u1 = vd_sqrt(vd_add(vd_mul(a, a), vd_mul(b, b)));
+	bad = vm_or(vnear0(a, b), vd_gt(u1, k->r4));
+	theta = rs_atan2(b, a);
+	alpha = rs_acos(vd_div(u1, k->r4));
+	*t = rs_mod2pi(vd_add(vd_set1(MPIDIV2), vd_add(alpha, theta)));
+	*u = rs_mod2pi(vd_sub(vd_set1(MPI), vd_add(alpha, alpha)));
+	*v = rs_mod2pi(vd_sub(vd_sub(phi, *t), *u));
+
+	return(vd_sel(bad, RS_VINF, vd_mul(k->r, vd_add(*t, vd_add(*u, *v)))));
+}
+
+
+/***********************************************************/
+static inline vd vc_cc(const vradcurv* k, vd x, vd y, vd phi, vd rs, vd rc, vd* t, vd* u, vd* v)
+{
+	vd a, b, u1, theta, alpha;
+	vm bad;
+
+	a = vd_sub(x, rs);
+	b = vd_add(y, rc);
+	u1 = vd_sqrt(vd_add(vd_mul(a, a), vd_mul(b, b)));
+	bad = vm_or(vnear0(a, b), vd_gt(u1, k->r4));
+	theta = rs_atan2(b, a);
+	alpha = rs_acos(vd_div(u1, k->r4));
+	*t = rs_mod2pi(vd_add(vd_set1(MPIDIV2), vd_add(alpha, theta)));
+	*u = rs_mod2pi(vd_sub(vd_set1(MPI), vd_add(alpha, alpha)));
+	*v = rs_mod2pi(vd_sub(vd_add(*t, *u), phi));
+
+	return(vd_sel(bad, RS_VINF, vd_mul(k->r, vd_add(*t, vd_add(*u, *v)))));
+}
+
+
+/***********************************************************/
+static inline vd vcsca(const vradcurv* k, vd x, vd y, vd phi, vd rs, vd rc, vd* t, vd* u, vd* v)
+{
+	vd a, b;
+
+	a = vd_sub(x, rs);
+	b = vd_add(y, rc);
+	*t = rs_mod2pi(rs_atan2(b, a));
+	*u = vd_sqrt(vd_add(vd_mul(a, a), vd_mul(b, b)));
+	*v = rs_mod2pi(vd_sub(phi, *t));
+
+	return(vd_add(vd_mul(k->r, vd_add(*t, *v)), *u));
+}
+
+
+/***********************************************************/
+static inline vd vcscb(const vradcurv* k, vd x, vd y, vd phi, vd rs, vd rc, vd* t, vd* u, vd* v)
+{
+	vd a, b, u1, theta, alpha;
+	vm bad;
+
+	a = vd_add(x, rs);
+	b = vd_sub(y, rc);
+	u1 = vd_sqrt(vd_add(vd_mul(a, a), vd_mul(b, b)));
+	bad = vd_lt(u1, k->r2);
+	theta = rs_atan2(b, a);
+	*u = vd_sqrt(vd_sub(vd_mul(u1, u1), k->sqr2));
+	alpha = rs_atan2(k->r2, *u);
+	*t = rs_mod2pi(vd_add(theta, alpha));
+	*v = rs_mod2pi(vd_sub(*t, phi));
+
+	return(vd_sel(bad, RS_VINF, vd_add(vd_mul(k->r, vd_add(*t, *v)), *u)));
+}
+
+
+/***********************************************************/
+static inline vd vccu_cuc(const vradcurv* k, vd x, vd y, vd phi, vd rs, vd rc, vd* t, vd* u, vd* v)
+{
+	vd a, b, u1, theta, alpha, half;
+	vm bad, far;
+
+	a = vd_add(x, rs);
+	b = vd_sub(y, rc);
+	u1 = vd_sqrt(vd_add(vd_mul(a, a), vd_mul(b, b)));
+	bad = vm_or(vnear0(a, b), vd_gt(u1, k->r4));
+	theta = rs_atan2(b, a);
+	far = vd_gt(u1, k->r2);
+	half = vd_mul(u1, vd_set1(0.5));
+	alpha = rs_acos(vd_div(vd_sel(far, vd_sub(half, k->r), vd_add(half, k->r)), k->r2));
+	*t = rs_mod2pi(vd_add(vd_set1(MPIDIV2), vd_add(theta, vd_sel(far, vd_neg(alpha), alpha))));
+	*u = rs_mod2pi(vd_sel(far, vd_sub(vd_set1(MPI), alpha), alpha));
+	*v = rs_mod2pi(vd_add(vd_sub(phi, *t), vd_add(*u, *u)));
+
+	return(vd_sel(bad, RS_VINF, vd_mul(k->r, vd_add(vd_add(*u, *u), vd_add(*t, *v)))));
+}
+
+
+/***********************************************************/
+static inline vd vc_cucu_c(const vradcurv* k, vd x, vd y, vd phi, vd rs, vd rc, vd* t, vd* u, vd* v)
+{
+	vd a, b, u1, theta, alpha, va1, va2;
+	vm bad;
+
+	a = vd_add(x, rs);
+	b = vd_sub(y, rc);
+	u1 = vd_sqrt(vd_add(vd_mul(a, a), vd_mul(b, b)));
+	bad = vm_or(vnear0(a, b), vd_gt(u1, vd_mul(vd_set1(6.0), k->r)));
+	theta = rs_atan2(b, a);
+	va1 = vd_div(vd_sub(vd_mul(vd_set1(5.0), k->sqr), vd_mul(vd_mul(u1, u1), vd_set1(0.25))), k->sqr2);
+	bad = vm_or(bad, vm_or(vd_lt(va1, vd_set1(0.0)), vd_gt(va1, vd_set1(1.0))));
+	*u = rs_acos(va1);
+	va2 = vd_sqrt(vd_mul(vd_sub(vd_set1(1.0), va1), vd_add(vd_set1(1.0), va1)));
+	alpha = rs_asin(vd_div(vd_mul(k->r2, va2), u1));
+	*t = rs_mod2pi(vd_add(vd_set1(MPIDIV2), vd_add(theta, alpha)));
+	*v = rs_mod2pi(vd_sub(*t, phi));
+
+	return(vd_sel(bad, RS_VINF, vd_mul(k->r, vd_add(vd_add(*u, *u), vd_add(*t, *v)))));
+}
+
+
+/***********************************************************/
+static inline vd vc_c2sca(const vradcurv* k, vd x, vd y, vd phi, vd rs, vd rc, vd* t, vd* u, vd* v)
+{
+	vd a, b, u1, theta, alpha;
+	vm bad;
+
+	a = vd_sub(x, rs);
+	b = vd_add(y, rc);
+	u1 = vd_sqrt(vd_add(vd_mul(a, a), vd_mul(b, b)));
+	theta = rs_atan2(b, a);
+	*u = vd_sub(vd_sqrt(vd_sub(vd_mul(u1, u1), k->sqr2)), k->r2);
+	bad = vm_or(vd_lt(u1, k->r2), vd_lt(*u, vd_set1(0.0)));
+	alpha = rs_atan2(k->r2, vd_add(*u, k->r2));
+	*t = rs_mod2pi(vd_add(vd_set1(MPIDIV2), vd_add(theta, alpha)));
+	*v = rs_mod2pi(vd_sub(vd_add(*t, vd_set1(MPIDIV2)), phi));
+
+	return(vd_sel(bad, RS_VINF, vd_add(vd_mul(k->r, vd_add(vd_add(*t, vd_set1(MPIDIV2)), *v)), *u)));
+}
+
+
+/***********************************************************/
+static inline vd vc_c2scb(const vradcurv* k, vd x, vd y, vd phi, vd rs, vd rc, vd* t, vd* u, vd* v)
+{
+	vd a, b, u1, theta;
+	vm bad;
+
+	a = vd_add(x, rs);
+	b = vd_sub(y, rc);
+	u1 = vd_sqrt(vd_add(vd_mul(a, a), vd_mul(b, b)));
+	bad = vd_lt(u1, k->r2);
+	theta = rs_atan2(b, a);
+	*t = rs_mod2pi(vd_add(vd_set1(MPIDIV2), theta));
+	*u = vd_sub(u1, k->r2);
+	*v = rs_mod2pi(vd_sub(vd_sub(phi, *t), vd_set1(MPIDIV2)));
+
+	return(vd_sel(bad, RS_VINF, vd_add(vd_mul(k->r, vd_add(vd_add(*t, vd_set1(MPIDIV2)), *v)), *u)));
+}
+
+
+/***********************************************************/
+static inline vd vc_c2sc2_c(const vradcurv* k, vd x, vd y, vd phi, vd rs, vd rc, vd* t, vd* u, vd* v)
+{
+	vd a, b, u1, theta, alpha;
+	vm bad;
+
+	a = vd_add(x, rs);
+	b = vd_sub(y, rc);
+	u1 = vd_sqrt(vd_add(vd_mul(a, a), vd_mul(b, b)));
+	theta = rs_atan2(b, a);
+	*u = vd_sub(vd_sqrt(vd_sub(vd_mul(u1, u1), k->sqr2)), k->r4);
+	bad = vm_or(vd_lt(u1, k->r4), vd_lt(*u, vd_set1(0.0)));
+	alpha = rs_atan2(k->r2, vd_add(*u, k->r4));
+	*t = rs_mod2pi(vd_add(vd_set1(MPIDIV2), vd_add(theta, alpha)));
+	*v = rs_mod2pi(vd_sub(*t, phi));
+
+	return(vd_sel(bad, RS_VINF, vd_add(vd_mul(k->r, vd_add(vd_add(*t, vd_set1(MPI)), *v)), *u)));
+}
+
+
+/***********************************************************/
+static inline vd vcc_c(const vradcurv* k, vd x, vd y, vd phi, vd rs, vd rc, vd* t, vd* u, vd* v)
+{
+	vd a, b, u1, theta, alpha, w, va, small;
+	vm bad, tiny;
+
+	a = vd_sub(x, rs);
+	b = vd_add(y, rc);
+	u1 = vd_sqrt(vd_add(vd_mul(a, a), vd_mul(b, b)));
+	bad = vm_or(vnear0(a, b), vd_gt(u1, k->r4));
+	theta = rs_atan2(b, a);
+	w = vd_div(vd_sub(vd_mul(vd_set1(8.0), k->sqr), vd_mul(u1, u1)), vd_mul(vd_set1(8.0), k->sqr));
+	*u = rs_acos(w);
+	va = vd_sqrt(vd_mul(vd_sub(vd_set1(1.0), w), vd_add(vd_set1(1.0), w)));
+	small = vd_set1(0.001);
+	tiny = vd_lt(vd_abs(va), small);
+	bad = vm_or(bad, vm_and(tiny, vd_lt(vd_abs(u1), small)));
+	alpha = rs_asin(vd_div(vd_mul(k->r2, va), u1));
+	*t = rs_mod2pi(vd_add(vd_sub(vd_set1(MPIDIV2), alpha), theta));
+	*v = rs_mod2pi(vd_sub(vd_sub(*t, *u), phi));
+
+	return(vd_sel(bad, RS_VINF, vd_mul(k->r, vd_add(*t, vd_add(*u, *v)))));
+}
+
+
+/***********************************************************/
+static inline vd vcsc2_ca(const vradcurv* k, vd x, vd y, vd phi, vd rs, vd rc, vd* t, vd* u, vd* v)
+{
+	vd a, b, u1, theta, alpha;
+	vm bad;
+
+	a = vd_sub(x, rs);
+	b = vd_add(y, rc);
+	u1 = vd_sqrt(vd_add(vd_mul(a, a), vd_mul(b, b)));
+	theta = rs_atan2(b, a);
+	*u = vd_sub(vd_sqrt(vd_sub(vd_mul(u1, u1), k->sqr2)), k->r2);
+	bad = vm_or(vd_lt(u1, k->r2), vd_lt(*u, vd_set1(0.0)));
+	alpha = rs_atan2(vd_add(*u, k->r2), k->r2);
+	*t = rs_mod2pi(vd_sub(vd_add(vd_set1(MPIDIV2), theta), alpha));
+	*v = rs_mod2pi(vd_sub(vd_sub(*t, vd_set1(MPIDIV2)), phi));
+
+	return(vd_sel(bad, RS_VINF, vd_add(vd_mul(k->r, vd_add(vd_add(*t, vd_set1(MPIDIV2)), *v)), *u)));
+}
+
+
+/***********************************************************/
+static inline vd vcsc2_cb(const vradcurv* k, vd x, vd y, vd phi, vd rs, vd rc, vd* t, vd* u, vd* v)
+{
+	vd a, b, u1, theta;
+	vm bad;
+
+	a = vd_add(x, rs);
+	b = vd_sub(y, rc);
+	u1 = vd_sqrt(vd_add(vd_mul(a, a), vd_mul(b, b)));
+	bad = vd_lt(u1, k->r2);
+	theta = rs_atan2(b, a);
+	*t = rs_mod2pi(theta);
+	*u = vd_sub(u1, k->r2);
+	*v = rs_mod2pi(vd_sub(vd_sub(phi, *t), vd_set1(MPIDIV2)));
+
+	return(vd_sel(bad, RS_VINF, vd_add(vd_mul(k->r, vd_add(vd_add(*t, vd_set1(MPIDIV2)), *v)), *u)));
+}
+
+
+/***********************************************************/
+/*
+Curve number of each reflection, minus the first number of the family.
+The families c_c_c and c_cc list their reflections in the order of the
+lanes, the other ones swap (-x,y,-phi) and (x,-y,-phi). The tables are
+repeated so that they can be loaded at any lane offset.
+*/
+static const rs_real RS_ALIGN word_ccc[20] = { 0, 1, 2, 3, 0, 1, 2, 3, 0, 1, 2, 3, 0, 1, 2, 3, 0, 1, 2, 3 };
+static const rs_real RS_ALIGN word_other[20] = { 0, 2, 1, 3, 0, 2, 1, 3, 0, 2, 1, 3, 0, 2, 1, 3, 0, 2, 1, 3 };
+
+/* signs of x, y and phi of each reflection */
+static const rs_real sign_x[4] = { 1.0, -1.0, 1.0, -1.0 };
+static const rs_real sign_y[4] = { 1.0, 1.0, -1.0, -1.0 };
+static const rs_real sign_phi[4] = { 1.0, -1.0, -1.0, 1.0 };
+
+/* keeps, lane by lane, the curves shorter than the best ones */
+#define RS_KEEP(kernel, rc, first, words) \
+	var = kernel(&k, x, y, phi, rs, rc, &tn, &un, &vn); \
+	better = vd_lt(var, length); \
+	length = vd_sel(better, var, length); \
+	num = vd_sel(better, vd_add(vd_set1(first), words), num); \
+	t = vd_sel(better, tn, t); \
+	u = vd_sel(better, un, u); \
+	v = vd_sel(better, vn, v);
+
+#define RS_SIMD_BLOCK 16
+#define RS_SIMD_LANES (4 * RS_SIMD_BLOCK)
+
+void RS_SOLVE(const rs_context* ctx, int n, const rs_real* qx, const rs_real* qy, const rs_real* qphi,
+	rs_real* qlength, int* qnumero, rs_real* qtr, rs_real* qur, rs_real* qvr)
+{
+	rs_real RS_ALIGN lx[RS_SIMD_LANES], ly[RS_SIMD_LANES], lphi[RS_SIMD_LANES], lrs[RS_SIMD_LANES], lb1[RS_SIMD_LANES], lb2[RS_SIMD_LANES];
+	rs_real RS_ALIGN llength[RS_SIMD_LANES], lnum[RS_SIMD_LANES], lt[RS_SIMD_LANES], lu[RS_SIMD_LANES], lv[RS_SIMD_LANES];
+	rs_real sphi[RS_SIMD_BLOCK], cphi[RS_SIMD_BLOCK], radcurv;
+	vradcurv k;
+	vd x, y, phi, rs, b1, b2, wccc, wother;
+	vd length, num, t, u, v, var, tn, un, vn;
+	vm better;
+	int i, j, l, q, r, m, lanes, best;
+
+	k.r = vd_set1(ctx->radcurv);
+	k.r2 = vd_set1(ctx->radcurvmul2);
+	k.r4 = vd_set1(ctx->radcurvmul4);
+	k.sqr = vd_set1(ctx->sqradcurv);
+	k.sqr2 = vd_set1(ctx->sqradcurvmul2);
+	radcurv = (rs_real)ctx->radcurv;
+
+	for (i = 0; i < n; i += RS_SIMD_BLOCK)
+	{
+		m = (n - i < RS_SIMD_BLOCK) ? n - i : RS_SIMD_BLOCK;
+		lanes = (4 * m + RS_W - 1) / RS_W * RS_W;
+
+		for (j = 0; j < m; j++)
+		{
+			sphi[j] = radcurv * RS_SIN(qphi[i + j]);
+			cphi[j] = radcurv * RS_COS(qphi[i + j]);
+		}
+
+		/* the lanes past the last query repeat it */
+		for (l = 0; l < lanes; l++)
+		{
+			q = (l / 4 < m) ? l / 4 : m - 1;
+			r = l % 4;
+			lx[l] = sign_x[r] * qx[i + q];
+			ly[l] = sign_y[r] * qy[i + q];
+			lphi[l] = sign_phi[r] * qphi[i + q];
+			lrs[l] = sign_phi[r] * sphi[q];
+			lb1[l] = cphi[q] - radcurv;
+			lb2[l] = cphi[q] + radcurv;
+		}
+
+		for (l = 0; l < lanes; l += RS_W)
+		{
+			x = vd_load(lx + l);
+			y = vd_load(ly + l);
+			phi = vd_load(lphi + l);
+			rs = vd_load(lrs + l);
+			b1 = vd_load(lb1 + l);
+			b2 = vd_load(lb2 + l);
+			wccc = vd_load(word_ccc + l % 4);
+			wother = vd_load(word_other + l % 4);
+
+			length = vd_set1(HUGE_VAL);
+			num = t = u = v = vd_set1(0.0);
+
+			RS_KEEP(vc_c_c, b1, 1, wccc)
+			RS_KEEP(vc_cc, b1, 5, wccc)
+			RS_KEEP(vcsca, b1, 9, wother)
+			RS_KEEP(vcscb, b2, 13, wother)
+			RS_KEEP(vccu_cuc, b2, 17, wother)
+			RS_KEEP(vc_cucu_c, b2, 21, wother)
+			RS_KEEP(vc_c2sca, b1, 25, wother)
+			RS_KEEP(vc_c2scb, b2, 29, wother)
+			RS_KEEP(vc_c2sc2_c, b2, 33, wother)
+			RS_KEEP(vcc_c, b1, 37, wother)
+			RS_KEEP(vcsc2_ca, b1, 41, wother)
+			RS_KEEP(vcsc2_cb, b2, 45, wother)
+
+			vd_store(llength + l, length);
+			vd_store(lnum + l, num);
+			vd_store(lt + l, t);
+			vd_store(lu + l, u);
+			vd_store(lv + l, v);
+		}
+
+		/* shortest of the four reflections of each query */
+		for (j = 0; j < m; j++)
+		{
+			best = 4 * j;
+			for (l = 4 * j + 1; l < 4 * j + 4; l++)
+				if ((llength[l] < llength[best]) || ((llength[l] == llength[best]) && (lnum[l] < lnum[best])))
+					best = l;
+			qlength[i + j] = llength[best];
+			qnumero[i + j] = (int)lnum[best];
+			qtr[i + j] = lt[best];
+			qur[i + j] = lu[best];
+			qvr[i + j] = lv[best];
+		}
+	}
+}
+
+#endif
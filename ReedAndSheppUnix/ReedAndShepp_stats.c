@@ -0,0 +1,216 @@
+// ReedAndShepp_stats.c : counters of the solver, per thread.
+//
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "ReedAndShepp.h"
+#include "ReedAndShepp_internal.h"
+
+/*
+
+Each thread counts in its own rs_stats_block, allocated the first time it
+records something while the counters are enabled, so that the threads
+never write to the same cache lines. The blocks are linked in a list read
+by rs_stats_snapshot. When a thread ends, its counts are added to
+rs_stats_retired and its block is freed.
+
+Only the owner of a block increments it, with relaxed atomic loads and
+stores rather than read-modify-write instructions, which is enough for
+rs_stats_snapshot and rs_stats_reset to read and clear it from another
+thread. An increment running during rs_stats_reset may survive it.
+
+*/
+
+typedef struct rs_stats_block
+{
+	rs_stats counts;
+	struct rs_stats_block* next;
+	struct rs_stats_block* prev;
+} rs_stats_block;
+
+int rs_stats_enabled = 0;
+
+static pthread_mutex_t rs_stats_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t rs_stats_once = PTHREAD_ONCE_INIT;
+static pthread_key_t rs_stats_key;
+static rs_stats_block* rs_stats_blocks = NULL;
+static rs_stats rs_stats_retired;
+static __thread rs_stats_block* rs_stats_local = NULL;
+
+#define RS_STATS_ADD(counter, n) \
+	__atomic_store_n(&(counter), __atomic_load_n(&(counter), __ATOMIC_RELAXED) + (n), __ATOMIC_RELAXED)
+
+
+/***********************************************************/
+/*
+Adds the counters of from to to, reading from with atomic loads.
+*/
+static void rs_stats_sum(rs_stats* to, rs_stats* from)
+{
+	int i;
+
+	to->queries += __atomic_load_n(&from->queries, __ATOMIC_RELAXED);
+	for (i = 0; i < 48; i++) to->wins[i] += __atomic_load_n(&from->wins[i], __ATOMIC_RELAXED);
+	to->sampled += __atomic_load_n(&from->sampled, __ATOMIC_RELAXED);
+	for (i = 0; i < 12; i++) to->rejections[i] += __atomic_load_n(&from->rejections[i], __ATOMIC_RELAXED);
+	to->paths += __atomic_load_n(&from->paths, __ATOMIC_RELAXED);
+	to->samples += __atomic_load_n(&from->samples, __ATOMIC_RELAXED);
+	to->cycles += __atomic_load_n(&from->cycles, __ATOMIC_RELAXED);
+}
+
+
+/***********************************************************/
+static void rs_stats_clear(rs_stats* stats)
+{
+	int i;
+
+	__atomic_store_n(&stats->queries, 0, __ATOMIC_RELAXED);
+	for (i = 0; i < 48; i++) __atomic_store_n(&stats->wins[i], 0, __ATOMIC_RELAXED);
+	__atomic_store_n(&stats->sampled, 0, __ATOMIC_RELAXED);
+	for (i = 0; i < 12; i++) __atomic_store_n(&stats->rejections[i], 0, __ATOMIC_RELAXED);
+	__atomic_store_n(&stats->paths, 0, __ATOMIC_RELAXED);
+	__atomic_store_n(&stats->samples, 0, __ATOMIC_RELAXED);
+	__atomic_store_n(&stats->cycles, 0, __ATOMIC_RELAXED);
+}
+
+
+/***********************************************************/
+/*
+Called when a thread that has a block ends.
+*/
+static void rs_stats_release(void* arg)
+{
+	rs_stats_block* block;
+
+	block = (rs_stats_block*)arg;
+	pthread_mutex_lock(&rs_stats_lock);
+	rs_stats_sum(&rs_stats_retired, &block->counts);
+	if (block->prev != NULL) block->prev->next = block->next;
+	else rs_stats_blocks = block->next;
+	if (block->next != NULL) block->next->prev = block->prev;
+	pthread_mutex_unlock(&rs_stats_lock);
+	free(block);
+}
+
+
+/***********************************************************/
+static void rs_stats_create_key(void)
+{
+	pthread_key_create(&rs_stats_key, rs_stats_release);
+}
+
+
+/***********************************************************/
+/*
+Returns the block of the calling thread, or NULL when it cannot be
+allocated.
+*/
+static rs_stats_block* rs_stats_block_of_thread(void)
+{
+	rs_stats_block* block;
+
+	if (rs_stats_local != NULL) return(rs_stats_local);
+
+	pthread_once(&rs_stats_once, rs_stats_create_key);
+	block = (rs_stats_block*)calloc(1, sizeof(rs_stats_block));
+	if (block == NULL) return(NULL);
+
+	pthread_mutex_lock(&rs_stats_lock);
+	block->next = rs_stats_blocks;
+	if (rs_stats_blocks != NULL) rs_stats_blocks->prev = block;
+	rs_stats_blocks = block;
+	pthread_mutex_unlock(&rs_stats_lock);
+
+	pthread_setspecific(rs_stats_key, block);
+	rs_stats_local = block;
+	return(block);
+}
+
+
+/***********************************************************/
+unsigned long long rs_stats_clock(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+	return(__rdtsc());
+#else
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return((unsigned long long)ts.tv_sec * 1000000000ULL + ts.tv_nsec);
+#endif
+}
+
+
+/***********************************************************/
+void rs_stats_add_solve(int n, const int* numero, int sampled, const unsigned int* rejections, unsigned long long cycles)
+{
+	rs_stats_block* block;
+	int i;
+
+	block = rs_stats_block_of_thread();
+	if (block == NULL) return;
+
+	RS_STATS_ADD(block->counts.queries, n);
+	for (i = 0; i < n; i++)
+		if ((numero[i] >= 1) && (numero[i] <= 48)) RS_STATS_ADD(block->counts.wins[numero[i] - 1], 1);
+	if (sampled != 0) RS_STATS_ADD(block->counts.sampled, sampled);
+	for (i = 0; i < 12; i++)
+		if (rejections[i] != 0) RS_STATS_ADD(block->counts.rejections[i], rejections[i]);
+	RS_STATS_ADD(block->counts.cycles, cycles);
+}
+
+
+/***********************************************************/
+void rs_stats_add_path(int samples)
+{
+	rs_stats_block* block;
+
+	block = rs_stats_block_of_thread();
+	if (block == NULL) return;
+
+	RS_STATS_ADD(block->counts.paths, 1);
+	RS_STATS_ADD(block->counts.samples, samples);
+}
+
+
+/***********************************************************/
+EXPORT
+void rs_stats_enable(int enabled)
+{
+	__atomic_store_n(&rs_stats_enabled, enabled != 0, __ATOMIC_RELAXED);
+}
+
+
+/***********************************************************/
+EXPORT
+void rs_stats_snapshot(rs_stats* stats)
+{
+	rs_stats_block* block;
+
+	memset(stats, 0, sizeof(rs_stats));
+	pthread_mutex_lock(&rs_stats_lock);
+	rs_stats_sum(stats, &rs_stats_retired);
+	for (block = rs_stats_blocks; block != NULL; block = block->next)
+		rs_stats_sum(stats, &block->counts);
+	pthread_mutex_unlock(&rs_stats_lock);
+}
+
+
+/***********************************************************/
+EXPORT
+void rs_stats_reset(void)
+{
+	rs_stats_block* block;
+
+	pthread_mutex_lock(&rs_stats_lock);
+	rs_stats_clear(&rs_stats_retired);
+	for (block = rs_stats_blocks; block != NULL; block = block->next)
+		rs_stats_clear(&block->counts);
+	pthread_mutex_unlock(&rs_stats_lock);
+}
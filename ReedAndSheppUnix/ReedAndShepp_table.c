@@ -0,0 +1,230 @@
+// ReedAndShepp_table.c : precomputed table of the lengths of the RS curves.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "ReedAndShepp.h"
+#include "ReedAndShepp_internal.h"
+
+/*
+
+The length of the shortest RS curve only depends on the increment of
+configuration (x,y,phi) computed in reed_shepp, and it is proportional to
+the turning radius: length(x,y,phi) = radcurv * length1(x/radcurv,
+y/radcurv, phi), where length1 is computed with a radius of 1. It is also
+unchanged by the symmetries (x,y,phi) -> (-x,y,-phi) and (x,-y,-phi), so
+length1 only needs to be known for x >= 0 and y >= 0.
+
+A table file holds an rs_table_header followed by the nx * ny * nphi
+values of length1, as floats, at x = i * xmax / (nx - 1),
+y = j * ymax / (ny - 1) and phi = -MPI + k * MPIMUL2 / nphi, stored at
+index (i * ny + j) * nphi + k. The file is mapped in memory by
+rs_table_open and is read by trilinear interpolation, phi wrapping around.
+
+*/
+
+#define RS_TABLE_MAGIC "RSTABLE1"
+
+typedef struct
+{
+	char magic[8];
+	int nx;
+	int ny;
+	int nphi;
+	int reserved;
+	double xmax;
+	double ymax;
+} rs_table_header;
+
+struct rs_table
+{
+	void* map;
+	size_t size;
+	int nx;
+	int ny;
+	int nphi;
+	double xmax;
+	double ymax;
+	double xscale;		/* (nx - 1) / xmax */
+	double yscale;		/* (ny - 1) / ymax */
+	double phiscale;	/* nphi / MPIMUL2 */
+	const float* values;
+};
+
+
+/***********************************************************/
+EXPORT
+int rs_table_build(const char* path, int nx, int ny, int nphi, double xmax, double ymax)
+{
+	rs_table_header header;
+	rs_context* unit;
+	float* row;
+	FILE* file;
+	int i, j, k, ok;
+
+	if ((nx < 2) || (ny < 2) || (nphi < 1) || (xmax <= 0) || (ymax <= 0)) return(0);
+
+	file = fopen(path, "wb");
+	if (file == NULL) return(0);
+
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, RS_TABLE_MAGIC, 8);
+	header.nx = nx;
+	header.ny = ny;
+	header.nphi = nphi;
+	header.xmax = xmax;
+	header.ymax = ymax;
+
+	unit = rs_context_create(1.0);
+	row = (float*)malloc(nphi * sizeof(float));
+	ok = (unit != NULL) && (row != NULL) && (fwrite(&header, sizeof(header), 1, file) == 1);
+
+	for (i = 0; ok && (i < nx); i++)
+		for (j = 0; ok && (j < ny); j++)
+		{
+			for (k = 0; k < nphi; k++)
+				row[k] = (float)reed_shepp_length_ctx(unit, 0.0, 0.0, 0.0,
+					i * xmax / (nx - 1), j * ymax / (ny - 1), -MPI + k * MPIMUL2 / nphi);
+			ok = (fwrite(row, sizeof(float), nphi, file) == (size_t)nphi);
+		}
+
+	free(row);
+	rs_context_destroy(unit);
+	if (fclose(file) != 0) ok = 0;
+	return(ok);
+}
+
+
+/***********************************************************/
+EXPORT
+rs_table* rs_table_open(const char* path)
+{
+	rs_table_header header;
+	struct stat st;
+	rs_table* table;
+	void* map;
+	int fd;
+
+	fd = open(path, O_RDONLY);
+	if (fd < 0) return(NULL);
+
+	if ((fstat(fd, &st) != 0) || (st.st_size < (off_t)sizeof(header)))
+	{
+		close(fd);
+		return(NULL);
+	}
+
+	map = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (map == MAP_FAILED) return(NULL);
+
+	memcpy(&header, map, sizeof(header));
+	if ((memcmp(header.magic, RS_TABLE_MAGIC, 8) != 0)
+		|| (header.nx < 2) || (header.ny < 2) || (header.nphi < 1)
+		|| (header.xmax <= 0) || (header.ymax <= 0)
+		|| ((size_t)st.st_size != sizeof(header) + (size_t)header.nx * header.ny * header.nphi * sizeof(float)))
+	{
+		munmap(map, st.st_size);
+		return(NULL);
+	}
+
+	table = (rs_table*)malloc(sizeof(rs_table));
+	if (table == NULL)
+	{
+		munmap(map, st.st_size);
+		return(NULL);
+	}
+
+	table->map = map;
+	table->size = st.st_size;
+	table->nx = header.nx;
+	table->ny = header.ny;
+	table->nphi = header.nphi;
+	table->xmax = header.xmax;
+	table->ymax = header.ymax;
+	table->xscale = (header.nx - 1) / header.xmax;
+	table->yscale = (header.ny - 1) / header.ymax;
+	table->phiscale = header.nphi / MPIMUL2;
+	table->values = (const float*)((const char*)map + sizeof(header));
+	return(table);
+}
+
+
+/***********************************************************/
+EXPORT
+void rs_table_close(rs_table* table)
+{
+	if (table == NULL) return;
+	munmap(table->map, table->size);
+	free(table);
+}
+
+
+/***********************************************************/
+EXPORT
+double reed_shepp_table_length_ctx(const rs_table* table, const rs_context* ctx, double x1, double y1, double t1, double x2, double y2, double t2)
+{
+	double dx, dy, ct, st, x, y, phi, fx, fy, fphi, l0, l1;
+	const float *p00, *p01, *p10, *p11;
+	int i, j, k, k1, nphi;
+
+	if (table == NULL) return(reed_shepp_length_ctx(ctx, x1, y1, t1, x2, y2, t2));
+
+	/* coordinate change, normalized by the radius and folded by symmetry */
+	dx = x2 - x1;
+	dy = y2 - y1;
+	ct = cos(t1);
+	st = sin(t1);
+	x = (dx * ct + dy * st) / ctx->radcurv;
+	y = (dy * ct - dx * st) / ctx->radcurv;
+	phi = t2 - t1;
+	if (x < 0) { x = -x; phi = -phi; }
+	if (y < 0) { y = -y; phi = -phi; }
+
+	/* exact length outside of the table, and for NaN */
+	if (!((x < table->xmax) && (y < table->ymax)))
+		return(reed_shepp_length_ctx(ctx, x1, y1, t1, x2, y2, t2));
+
+	x *= table->xscale;
+	y *= table->yscale;
+	phi = (phi + MPI) * table->phiscale;
+	phi -= floor(phi / table->nphi) * table->nphi;
+
+	/* x * xscale may round up to nx - 1 for x just below xmax */
+	i = (int)x;
+	j = (int)y;
+	if (i > table->nx - 2) i = table->nx - 2;
+	if (j > table->ny - 2) j = table->ny - 2;
+	k = (int)phi;
+	nphi = table->nphi;
+	if (k >= nphi) k = nphi - 1;
+	k1 = (k + 1 < nphi) ? k + 1 : 0;
+	fx = x - i;
+	fy = y - j;
+	fphi = phi - k;
+
+	p00 = table->values + ((size_t)i * table->ny + j) * nphi;
+	p01 = p00 + nphi;
+	p10 = p00 + (size_t)table->ny * nphi;
+	p11 = p10 + nphi;
+
+	l0 = (1 - fy) * ((1 - fphi) * p00[k] + fphi * p00[k1]) + fy * ((1 - fphi) * p01[k] + fphi * p01[k1]);
+	l1 = (1 - fy) * ((1 - fphi) * p10[k] + fphi * p10[k1]) + fy * ((1 - fphi) * p11[k] + fphi * p11[k1]);
+
+	return(ctx->radcurv * ((1 - fx) * l0 + fx * l1));
+}
+
+
+/***********************************************************/
+EXPORT
+double reed_shepp_table_length(const rs_table* table, double x1, double y1, double t1, double x2, double y2, double t2)
+{
+	return(reed_shepp_table_length_ctx(table, &rs_default, x1, y1, t1, x2, y2, t2));
+}